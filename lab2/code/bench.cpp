@@ -0,0 +1,367 @@
+// bench.cpp : benchmarks of Set, UnrolledSet and PoolSet against std::set, std::flat_set and a dense bitset
+// Writes one JSON array to stdout: one object per backend, operation and input shape
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#if __has_include(<flat_set>)
+#include <flat_set>
+#endif
+
+#include "set.h"
+#include "unrolled_set.h"
+#include "pool_set.h"
+
+/****************************************
+ * Allocation counting                   *
+ *****************************************/
+
+namespace {
+std::atomic<long long> n_allocations{0};
+std::atomic<long long> n_bytes{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+    n_allocations.fetch_add(1, std::memory_order_relaxed);
+    n_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/****************************************
+ * Backends                              *
+ *****************************************/
+
+namespace {
+// Each backend builds a set from sorted unique ints and implements the benchmarked operations
+
+struct ListBackend {
+    static constexpr const char* name = "Set";
+    using type = Set;
+
+    static type build(const std::vector<int>& v) {
+        return Set{v};
+    }
+    static bool contains(const type& s, int x) {
+        return s.is_member(x);
+    }
+    static void unite(type& a, const type& b) {
+        a += b;
+    }
+    static void intersect(type& a, const type& b) {
+        a *= b;
+    }
+    static void subtract(type& a, const type& b) {
+        a -= b;
+    }
+    static bool is_subset(const type& a, const type& b) {
+        return (a <=> b) <= 0;
+    }
+};
+
+struct UnrolledBackend {
+    static constexpr const char* name = "UnrolledSet";
+    using type = UnrolledSet;
+
+    static type build(const std::vector<int>& v) {
+        return UnrolledSet{std::span<const int>{v}};
+    }
+    static bool contains(const type& s, int x) {
+        return s.is_member(x);
+    }
+    static void unite(type& a, const type& b) {
+        a += b;
+    }
+    static void intersect(type& a, const type& b) {
+        a *= b;
+    }
+    static void subtract(type& a, const type& b) {
+        a -= b;
+    }
+    static bool is_subset(const type& a, const type& b) {
+        return a.cardinality() <= b.cardinality() && std::includes(b.begin(), b.end(), a.begin(), a.end());
+    }
+};
+
+struct PoolBackend {
+    static constexpr const char* name = "PoolSet";
+    using type = PoolSet;
+
+    static type build(const std::vector<int>& v) {
+        return PoolSet{std::span<const int>{v}};
+    }
+    static bool contains(const type& s, int x) {
+        return s.is_member(x);
+    }
+    static void unite(type& a, const type& b) {
+        a += b;
+    }
+    static void intersect(type& a, const type& b) {
+        a *= b;
+    }
+    static void subtract(type& a, const type& b) {
+        a -= b;
+    }
+    static bool is_subset(const type& a, const type& b) {
+        return a.cardinality() <= b.cardinality() && std::includes(b.begin(), b.end(), a.begin(), a.end());
+    }
+};
+
+struct StdSetBackend {
+    static constexpr const char* name = "std::set";
+    using type = std::set<int>;
+
+    static type build(const std::vector<int>& v) {
+        return type(v.begin(), v.end());
+    }
+    static bool contains(const type& s, int x) {
+        return s.contains(x);
+    }
+    static void unite(type& a, const type& b) {
+        a.insert(b.begin(), b.end());
+    }
+    static void intersect(type& a, const type& b) {
+        std::erase_if(a, [&b](int x) { return !b.contains(x); });
+    }
+    static void subtract(type& a, const type& b) {
+        for (int x : b) {
+            a.erase(x);
+        }
+    }
+    static bool is_subset(const type& a, const type& b) {
+        return std::includes(b.begin(), b.end(), a.begin(), a.end());
+    }
+};
+
+#if __has_include(<flat_set>)
+using flat_type = std::flat_set<int>;
+constexpr const char* flat_name = "std::flat_set";
+#else
+using flat_type = std::vector<int>;  // std::flat_set is a sorted vector
+constexpr const char* flat_name = "sorted std::vector";
+#endif
+
+struct FlatSetBackend {
+    static constexpr const char* name = flat_name;
+    using type = flat_type;
+
+    static type build(const std::vector<int>& v) {
+        return type(v.begin(), v.end());
+    }
+    static bool contains(const type& s, int x) {
+        return std::binary_search(s.begin(), s.end(), x);
+    }
+    static void unite(type& a, const type& b) {
+        std::vector<int> r;
+        r.reserve(a.size() + b.size());
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r));
+        a = type(r.begin(), r.end());
+    }
+    static void intersect(type& a, const type& b) {
+        std::vector<int> r;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r));
+        a = type(r.begin(), r.end());
+    }
+    static void subtract(type& a, const type& b) {
+        std::vector<int> r;
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r));
+        a = type(r.begin(), r.end());
+    }
+    static bool is_subset(const type& a, const type& b) {
+        return std::includes(b.begin(), b.end(), a.begin(), a.end());
+    }
+};
+
+struct BitsetBackend {
+    static constexpr const char* name = "bitset";
+    using type = std::vector<std::uint64_t>;  // bit x is set if x belongs to the set, x in [0, universe)
+
+    inline static std::size_t universe = 0;
+
+    static type build(const std::vector<int>& v) {
+        type s((universe + 63) / 64, 0);
+        for (int x : v) {
+            s[static_cast<std::size_t>(x) / 64] |= std::uint64_t{1} << (x % 64);
+        }
+        return s;
+    }
+    static bool contains(const type& s, int x) {
+        return x >= 0 && static_cast<std::size_t>(x) < universe &&
+               ((s[static_cast<std::size_t>(x) / 64] >> (x % 64)) & 1) != 0;
+    }
+    static void unite(type& a, const type& b) {
+        for (std::size_t i = 0; i < a.size(); ++i) a[i] |= b[i];
+    }
+    static void intersect(type& a, const type& b) {
+        for (std::size_t i = 0; i < a.size(); ++i) a[i] &= b[i];
+    }
+    static void subtract(type& a, const type& b) {
+        for (std::size_t i = 0; i < a.size(); ++i) a[i] &= ~b[i];
+    }
+    static bool is_subset(const type& a, const type& b) {
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if ((a[i] & ~b[i]) != 0) return false;
+        }
+        return true;
+    }
+};
+
+/****************************************
+ * Measurements                          *
+ *****************************************/
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto min_time = std::chrono::milliseconds{20};  // minimum measured time per operation
+constexpr int min_repetitions = 3;
+
+volatile long long sink = 0;  // keeps results alive
+
+struct Shape {
+    std::size_t n;     // number of values in each operand
+    double density;    // n / universe
+    double overlap;    // fraction of the values of A that also belong to B
+};
+
+struct Result {
+    double ns_per_op;
+    double allocations_per_op;
+};
+
+/*
+ * Time op(), repeated until min_time has elapsed; prepare() is run untimed before each repetition
+ */
+template <typename Prepare, typename Op>
+Result measure(Prepare prepare, Op op, std::size_t ops_per_call = 1) {
+    Clock::duration total{};
+    long long allocations = 0;
+    int repetitions = 0;
+
+    while (total < min_time || repetitions < min_repetitions) {
+        prepare();
+        const long long a0 = n_allocations.load();
+        const auto t0 = Clock::now();
+        op();
+        total += Clock::now() - t0;
+        allocations += n_allocations.load() - a0;
+        ++repetitions;
+    }
+
+    const double ops = static_cast<double>(repetitions) * static_cast<double>(ops_per_call);
+    return Result{std::chrono::duration<double, std::nano>(total).count() / ops,
+                  static_cast<double>(allocations) / ops};
+}
+
+bool first_record = true;
+
+void report(const char* backend, const char* op, const Shape& shape, const Result& r, double bytes_per_element) {
+    std::cout << (first_record ? "[\n" : ",\n") << "  {\"backend\": \"" << backend << "\", \"op\": \"" << op
+              << "\", \"n\": " << shape.n << ", \"density\": " << shape.density << ", \"overlap\": " << shape.overlap
+              << ", \"ns_per_op\": " << r.ns_per_op << ", \"allocations_per_op\": " << r.allocations_per_op
+              << ", \"bytes_per_element\": " << bytes_per_element << "}";
+    first_record = false;
+}
+
+template <typename Backend>
+void run(const Shape& shape, const std::vector<int>& A, const std::vector<int>& B, const std::vector<int>& probes) {
+    using T = typename Backend::type;
+
+    // Footprint: bytes allocated to build A
+    const long long bytes0 = n_bytes.load();
+    T a = Backend::build(A);
+    const double bytes_per_element = static_cast<double>(n_bytes.load() - bytes0) / static_cast<double>(A.size());
+    const T b = Backend::build(B);
+
+    auto none = [] {};
+    report(Backend::name, "construct", shape,
+           measure(none, [&] { sink = sink + static_cast<long long>(Backend::contains(Backend::build(A), 0)); }),
+           bytes_per_element);
+    report(Backend::name, "copy", shape, measure(none, [&] {
+               T c{a};
+               sink = sink + static_cast<long long>(Backend::contains(c, 0));
+           }),
+           bytes_per_element);
+    report(Backend::name, "is_member", shape, measure(none, [&] {
+               for (int x : probes) sink = sink + static_cast<long long>(Backend::contains(a, x));
+           }, probes.size()),
+           bytes_per_element);
+
+    T c{};
+    report(Backend::name, "+=", shape, measure([&] { c = a; }, [&] { Backend::unite(c, b); }), bytes_per_element);
+    report(Backend::name, "*=", shape, measure([&] { c = a; }, [&] { Backend::intersect(c, b); }), bytes_per_element);
+    report(Backend::name, "-=", shape, measure([&] { c = a; }, [&] { Backend::subtract(c, b); }), bytes_per_element);
+    report(Backend::name, "<=>", shape,
+           measure(none, [&] { sink = sink + static_cast<long long>(Backend::is_subset(a, b)); }), bytes_per_element);
+}
+
+/*
+ * Draw n sorted unique ints in [0, universe)
+ */
+std::vector<int> sample(std::size_t n, std::size_t universe, std::mt19937& gen) {
+    std::vector<int> all(universe);
+    for (std::size_t i = 0; i < universe; ++i) all[i] = static_cast<int>(i);
+    std::vector<int> v;
+    std::ranges::sample(all, std::back_inserter(v), static_cast<std::ptrdiff_t>(n), gen);
+    return v;
+}
+}  // namespace
+
+/****************************************
+ * Main                                  *
+ *****************************************/
+
+int main() {
+    std::mt19937 gen{2024};
+
+    for (std::size_t n : {1000, 10000, 100000}) {
+        for (double density : {0.01, 0.5}) {
+            for (double overlap : {0.0, 0.5, 1.0}) {
+                const Shape shape{n, density, overlap};
+                const auto universe = static_cast<std::size_t>(static_cast<double>(n) / density);
+
+                // B shares overlap * n values with A, the others are drawn from the rest of the universe
+                const std::vector<int> A = sample(n, universe, gen);
+                std::vector<int> B;
+                std::ranges::sample(A, std::back_inserter(B), static_cast<std::ptrdiff_t>(overlap * n), gen);
+                std::vector<int> rest;
+                std::ranges::set_difference(sample(std::min(universe, 2 * n), universe, gen), A,
+                                            std::back_inserter(rest));
+                std::ranges::sample(rest, std::back_inserter(B), static_cast<std::ptrdiff_t>(n - B.size()), gen);
+                std::ranges::sort(B);
+
+                std::vector<int> probes(1000);
+                std::uniform_int_distribution<int> dist{0, static_cast<int>(universe) - 1};
+                std::ranges::generate(probes, [&] { return dist(gen); });
+
+                BitsetBackend::universe = universe;
+                run<ListBackend>(shape, A, B, probes);
+                run<UnrolledBackend>(shape, A, B, probes);
+                run<PoolBackend>(shape, A, B, probes);
+                run<StdSetBackend>(shape, A, B, probes);
+                run<FlatSetBackend>(shape, A, B, probes);
+                run<BitsetBackend>(shape, A, B, probes);
+            }
+        }
+    }
+
+    std::cout << "\n]\n";
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Class BloomFilter
+ *
+ * Blocked Bloom filter of ints: every int is hashed to one 512-bit block (one cache line)
+ * and sets n_hashes bits of that block, so a lookup touches a single cache line
+ * may_contain never returns false for an int that was added (no false negatives),
+ * and returns true for an int that was not added with a probability that decreases
+ * with the number of bits per int
+ */
+class BloomFilter {
+public:
+    /*
+     * Create an empty filter sized for capacity ints with bits_per_value bits each
+     * The number of bits set per int is bits_per_value * ln 2, which minimizes false positives
+     */
+    BloomFilter(size_t capacity, double bits_per_value)
+        : bits_per_int{std::max(bits_per_value, 1.0)},
+          n_hashes{std::clamp(static_cast<unsigned>(std::lround(bits_per_int * 0.6931)), 1u, 16u)},
+          max_values{std::max<size_t>(capacity, 64)},
+          blocks(static_cast<size_t>(std::ceil(static_cast<double>(max_values) * bits_per_int / 512.0))) {
+    }
+
+    void add(int val) {
+        const std::uint64_t h = hash(val);
+        Block& b = blocks[block_of(h)];
+        for (unsigned i = 0; i < n_hashes; ++i) {
+            const unsigned bit = bit_of(h, i);
+            b[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+        ++n_values;
+    }
+
+    bool may_contain(int val) const {
+        const std::uint64_t h = hash(val);
+        const Block& b = blocks[block_of(h)];
+        for (unsigned i = 0; i < n_hashes; ++i) {
+            const unsigned bit = bit_of(h, i);
+            if ((b[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Remove all ints, and resize the filter for capacity ints
+     */
+    void reset(size_t capacity) {
+        *this = BloomFilter{capacity, bits_per_int};
+    }
+
+    /*
+     * Number of ints the filter is sized for: beyond that, false positives increase
+     */
+    size_t capacity() const {
+        return max_values;
+    }
+
+    size_t size() const {
+        return n_values;
+    }
+
+    double bits_per_value() const {
+        return bits_per_int;
+    }
+
+    size_t memory_bytes() const {
+        return blocks.size() * sizeof(Block);
+    }
+
+    /*
+     * Expected false-positive rate for the current number of ints
+     */
+    double false_positive_rate() const {
+        const double bits = 512.0 * static_cast<double>(blocks.size());
+        return std::pow(1.0 - std::exp(-static_cast<double>(n_hashes) * static_cast<double>(n_values) / bits),
+                        static_cast<double>(n_hashes));
+    }
+
+    /*
+     * Well-mixed 64-bit hash of val (splitmix64 finalizer), also used by Set's fingerprint
+     */
+    static std::uint64_t hash(int val) {
+        std::uint64_t x = static_cast<std::uint32_t>(val) + 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+private:
+    struct alignas(64) Block : std::array<std::uint64_t, 8> {};
+
+    double bits_per_int;
+    unsigned n_hashes;
+    size_t max_values;
+    size_t n_values{0};
+    std::vector<Block> blocks;
+
+    size_t block_of(std::uint64_t h) const {
+        return static_cast<size_t>(((h >> 32) * blocks.size()) >> 32);  // blocks.size() < 2^32
+    }
+
+    // Bit i of the block: double hashing on the two halves of the low 32 bits of h
+    static unsigned bit_of(std::uint64_t h, unsigned i) {
+        const auto h1 = static_cast<unsigned>(h & 0xFFFF);
+        const auto h2 = static_cast<unsigned>((h >> 16) & 0xFFFF) | 1u;
+        return (h1 + i * h2) % 512;
+    }
+};
@@ -0,0 +1,427 @@
+#include "concurrent_set.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/*****************************************************
+ * Epoch-based reclamation                            *
+ ******************************************************/
+
+/*
+ * A Node unlinked in epoch e is retired, i.e. deleted only once the global epoch reaches e+2
+ * The global epoch can only advance when every thread inside a Guard has seen the current one,
+ * so no thread can still hold a pointer to a Node by the time it is deleted
+ */
+class ConcurrentSet::Epochs {
+public:
+    /*
+     * One record per thread, records are reused after their thread exits and never deallocated
+     */
+    struct alignas(64) Record {
+        std::atomic<std::uint64_t> state{0};  // (epoch << 1) | 1 while inside a Guard, 0 otherwise
+        std::atomic<bool> in_use{false};
+        Record* next{nullptr};
+        std::vector<std::pair<std::uint64_t, Node*>> retired;  // Nodes unlinked by this thread
+    };
+
+    static Record& local() {
+        thread_local Handle handle{};
+        return *handle.record;
+    }
+
+    static void enter(Record& r) {
+        r.state.store((global.load() << 1) | 1);
+    }
+
+    static void leave(Record& r) {
+        r.state.store(0, std::memory_order_release);
+    }
+
+    /*
+     * Delete p once no thread can be reading it anymore
+     */
+    static void retire(Node* p) {
+        Record& r = local();
+        r.retired.emplace_back(global.load(), p);
+        if (r.retired.size() % reclaim_period == 0) {
+            reclaim(r);
+        }
+    }
+
+private:
+    static constexpr std::size_t reclaim_period = 64;  // retirements between reclamation attempts
+
+    /*
+     * Owns the calling thread's Record, hands its pending retirements over when the thread exits
+     */
+    struct Handle {
+        Record* record;
+
+        Handle() : record{acquire()} {}
+
+        ~Handle() {
+            std::lock_guard lock{orphans.mutex};
+            orphans.nodes.insert(orphans.nodes.end(), record->retired.begin(), record->retired.end());
+            record->retired.clear();
+            record->in_use.store(false);
+        }
+    };
+
+    /*
+     * Retirements of exited threads, deleted at the latest when the program ends
+     */
+    struct Orphans {
+        std::mutex mutex;
+        std::vector<std::pair<std::uint64_t, Node*>> nodes;
+
+        ~Orphans() {
+            for (auto [epoch, p] : nodes) {
+                delete p;
+            }
+        }
+    };
+
+    inline static std::atomic<std::uint64_t> global{1};
+    inline static std::atomic<Record*> records{nullptr};
+    inline static Orphans orphans{};
+
+    static Record* acquire() {
+        for (Record* r = records.load(); r != nullptr; r = r->next) {
+            bool expected = false;
+            if (r->in_use.compare_exchange_strong(expected, true)) {
+                return r;
+            }
+        }
+
+        Record* r = new Record{};
+        r->in_use.store(true);
+        r->next = records.load();
+        while (!records.compare_exchange_weak(r->next, r)) {
+        }
+        return r;
+    }
+
+    /*
+     * Advance the global epoch if every active thread has seen it,
+     * then delete the retired Nodes that have become unreachable
+     */
+    static void reclaim(Record& self) {
+        std::uint64_t epoch = global.load();
+        bool all_seen = true;
+        for (Record* r = records.load(); r != nullptr; r = r->next) {
+            const std::uint64_t s = r->state.load();
+            if ((s & 1) != 0 && (s >> 1) != epoch) {
+                all_seen = false;
+                break;
+            }
+        }
+        if (all_seen && global.compare_exchange_strong(epoch, epoch + 1)) {
+            ++epoch;
+        }
+
+        auto is_safe = [epoch](const std::pair<std::uint64_t, Node*>& e) { return e.first + 2 <= epoch; };
+        auto free_safe = [&is_safe](std::vector<std::pair<std::uint64_t, Node*>>& v) {
+            std::erase_if(v, [&is_safe](const std::pair<std::uint64_t, Node*>& e) {
+                if (!is_safe(e)) return false;
+                delete e.second;
+                return true;
+            });
+        };
+
+        free_safe(self.retired);
+        if (std::unique_lock lock{orphans.mutex, std::try_to_lock}) {
+            free_safe(orphans.nodes);
+        }
+    }
+};
+
+/*
+ * RAII: the calling thread reads the list while the Guard exists
+ */
+class ConcurrentSet::Guard {
+public:
+    Guard() : record{Epochs::local()} {
+        Epochs::enter(record);
+    }
+
+    ~Guard() {
+        Epochs::leave(record);
+    }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+private:
+    Epochs::Record& record;
+};
+
+/*****************************************************
+ * Marked pointers                                    *
+ ******************************************************/
+
+namespace {
+constexpr std::uintptr_t mark_bit = 1;
+
+template <typename Node>
+Node* to_node(std::uintptr_t link) {
+    return reinterpret_cast<Node*>(link & ~mark_bit);
+}
+
+bool is_marked(std::uintptr_t link) {
+    return (link & mark_bit) != 0;
+}
+}  // namespace
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ * Destructor: deallocate all Nodes in the list
+ */
+ConcurrentSet::~ConcurrentSet() {
+    for (Node* list : {to_node<Node>(head.load()), reports.load()}) {
+        Node* p = list;
+        while (p != nullptr) {
+            Node* next = to_node<Node>(p->next.load());
+            delete p;
+            p = next;
+        }
+    }
+}
+
+/*
+ * Insert val into the Set
+ */
+bool ConcurrentSet::insert(int val) {
+    Guard guard{};
+    Node* n = nullptr;
+
+    while (true) {
+        Window w = find(val);
+        if (w.curr != nullptr && w.curr->value == val) {
+            stamp(w.curr->inserted);  // the insertion of val has taken effect
+            delete n;  // never published
+            return false;
+        }
+
+        if (n == nullptr) {
+            n = new Node{val, {}};
+        }
+        n->next.store(reinterpret_cast<std::uintptr_t>(w.curr), std::memory_order_relaxed);
+
+        std::uintptr_t expected = reinterpret_cast<std::uintptr_t>(w.curr);
+        if (w.link->compare_exchange_strong(expected, reinterpret_cast<std::uintptr_t>(n))) {
+            stamp(n->inserted);  // the linearization point, unless another thread stamped n first
+            return true;
+        }
+    }
+}
+
+/*
+ * Remove val from the Set
+ */
+bool ConcurrentSet::erase(int val) {
+    Guard guard{};
+
+    while (true) {
+        Window w = find(val);
+        if (w.curr == nullptr || w.curr->value != val) {
+            return false;
+        }
+
+        stamp(w.curr->inserted);  // a Node is removed only after its insertion took effect
+
+        std::uintptr_t succ = w.curr->next.load();
+        if (is_marked(succ)) {
+            continue;  // removed by another thread, find unlinks it
+        }
+
+        // Logical removal, which takes effect when the Node is stamped as removed
+        if (!w.curr->next.compare_exchange_strong(succ, succ | mark_bit)) {
+            continue;
+        }
+        stamp(w.curr->removed);
+
+        // Physical removal, left to later traversals if the predecessor changed
+        report_unlink(w.curr);
+        std::uintptr_t expected = reinterpret_cast<std::uintptr_t>(w.curr);
+        if (w.link->compare_exchange_strong(expected, succ)) {
+            Epochs::retire(w.curr);
+        } else {
+            find(val);
+        }
+        return true;
+    }
+}
+
+/*
+ * Test whether val belongs to the Set
+ */
+bool ConcurrentSet::is_member(int val) const {
+    Guard guard{};
+
+    Node* p = to_node<Node>(head.load(std::memory_order_acquire));
+    while (p != nullptr && p->value < val) {
+        p = to_node<Node>(p->next.load(std::memory_order_acquire));
+    }
+
+    if (p == nullptr || p->value != val) {
+        return false;
+    }
+    if (is_marked(p->next.load())) {
+        stamp(p->removed);  // the removal of val has taken effect
+        return false;
+    }
+    stamp(p->inserted);  // the insertion of val has taken effect
+    return true;
+}
+
+/*
+ * Return a copy of the Set as it was at a single instant: when version became v + 1
+ * A Node inserted at a version <= v was linked before, so the walk reaches it unless it was
+ * unlinked; it can only be unlinked after its removal was stamped, and if that version is > v
+ * the unlinking thread saw snapshots > 0 and reported the Node before unlinking it
+ */
+Set ConcurrentSet::snapshot() const {
+    Guard guard{};
+    snapshots.fetch_add(1);
+    const std::uint64_t v = version.fetch_add(1);
+
+    std::vector<int> values;
+    for (Node* p = to_node<Node>(head.load()); p != nullptr;) {
+        const std::uintptr_t next = p->next.load();
+        if (stamp(p->inserted) <= v && (!is_marked(next) || stamp(p->removed) > v)) {
+            values.push_back(p->value);
+        }
+        p = to_node<Node>(next);
+    }
+
+    bool reported = false;
+    for (Node* r = reports.load(); r != nullptr; r = to_node<Node>(r->next.load())) {
+        if (r->inserted.load() <= v && r->removed.load() > v) {
+            values.push_back(r->value);
+            reported = true;
+        }
+    }
+    if (reported) {  // a reported Node may also have been reached by the walk
+        std::ranges::sort(values);
+        values.erase(std::ranges::unique(values).begin(), values.end());
+    }
+
+    if (snapshots.fetch_sub(1) == 1) {  // the last snapshot in progress retires the reports
+        for (Node* r = reports.exchange(nullptr); r != nullptr;) {
+            Node* next = to_node<Node>(r->next.load());
+            Epochs::retire(r);
+            r = next;
+        }
+    }
+    return Set{values};
+}
+
+/*
+ * Insert all elements of Set S
+ */
+ConcurrentSet& ConcurrentSet::operator+=(const Set& S) {
+    for (int v : S) {
+        insert(v);
+    }
+    return *this;
+}
+
+/*
+ * Remove all elements that do not belong to Set S
+ */
+ConcurrentSet& ConcurrentSet::operator*=(const Set& S) {
+    for (int v : snapshot()) {
+        if (!S.is_member(v)) {
+            erase(v);
+        }
+    }
+    return *this;
+}
+
+/*
+ * Remove all elements of Set S
+ */
+ConcurrentSet& ConcurrentSet::operator-=(const Set& S) {
+    for (int v : S) {
+        erase(v);
+    }
+    return *this;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Return the version of stamp s, setting it to the current version first if it is 0
+ * If several threads stamp s at once, the first compare-exchange wins and all return its version
+ */
+std::uint64_t ConcurrentSet::stamp(std::atomic<std::uint64_t>& s) const {
+    std::uint64_t stamped = s.load();
+    if (stamped == 0) {
+        const std::uint64_t now = version.load();
+        if (s.compare_exchange_strong(stamped, now)) {
+            stamped = now;
+        }
+    }
+    return stamped;
+}
+
+/*
+ * Report Node p, about to be unlinked, to the snapshots in progress if any
+ * p was stamped as removed before snapshots is read: if a snapshot took a version smaller
+ * than the stamp, it had already incremented snapshots
+ * The copy of p is pushed before p is unlinked, so a snapshot that misses p in its walk
+ * finds the copy afterwards; a copy is only used by the snapshots that took a version
+ * smaller than its removal version, i.e. that started before the removal took effect
+ */
+void ConcurrentSet::report_unlink(const Node* p) {
+    if (snapshots.load() == 0) {
+        return;
+    }
+
+    Node* r = new Node{p->value, {}, p->inserted.load(), p->removed.load()};
+    Node* first = reports.load();
+    do {
+        r->next.store(reinterpret_cast<std::uintptr_t>(first), std::memory_order_relaxed);
+    } while (!reports.compare_exchange_weak(first, r));
+}
+
+/*
+ * Find the position of val, unlinking the marked Nodes on the way
+ */
+ConcurrentSet::Window ConcurrentSet::find(int val) {
+retry:
+    std::atomic<std::uintptr_t>* link = &head;
+    Node* curr = to_node<Node>(link->load());
+
+    while (curr != nullptr) {
+        const std::uintptr_t succ = curr->next.load();
+
+        if (is_marked(succ)) {
+            stamp(curr->removed);  // the removal takes effect before curr is unlinked
+            report_unlink(curr);
+            std::uintptr_t expected = reinterpret_cast<std::uintptr_t>(curr);
+            if (!link->compare_exchange_strong(expected, succ & ~mark_bit)) {
+                goto retry;  // the predecessor was changed or removed
+            }
+            Epochs::retire(curr);
+            curr = to_node<Node>(succ);
+            continue;
+        }
+
+        if (curr->value >= val) {
+            break;
+        }
+
+        link = &curr->next;
+        curr = to_node<Node>(succ);
+    }
+
+    return Window{link, curr};
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "set.h"
+
+/** Class to represent a Set of ints shared by several threads
+ *
+ * ConcurrentSet is implemented as a lock-free sorted singly linked list (Harris-Michael):
+ * a Node is erased by first marking the lowest bit of its next pointer (logical removal)
+ * and then unlinking it (physical removal), which any thread traversing the list may finish
+ * Unlinked Nodes are reclaimed with epoch-based reclamation, so a thread never
+ * dereferences a Node that another thread has already deleted
+ *
+ * insert, erase and is_member can be called concurrently from any number of threads
+ * snapshot returns a consistent (linearizable) copy as a Set, on which the bulk operations
+ * +, * and - of class Set can be applied
+ *
+ * Snapshots are versioned: each Set has a version, advanced by every snapshot, and an
+ * insertion or removal takes effect when its Node is stamped with the current version
+ * A snapshot taking version v keeps the Nodes inserted at a version <= v and not removed
+ * at a version <= v; it stamps the Nodes of the updates in progress itself (with a version > v),
+ * and Nodes unlinked while it walks the list are reported to it by the unlinking thread
+ * Hence no operation waits for another: a snapshot walks the list once, and insertions and
+ * removals only read the version and the number of snapshots of their own Set
+ */
+class ConcurrentSet {
+public:
+    /*
+     * Default constructor: create an empty ConcurrentSet
+     */
+    ConcurrentSet() = default;
+
+    /*
+     * Destructor: deallocate all Nodes in the list
+     * No other thread may be using the ConcurrentSet
+     */
+    ~ConcurrentSet();
+
+    /*
+     * Copying a ConcurrentSet is disallowed, use snapshot instead
+     */
+    ConcurrentSet(const ConcurrentSet&) = delete;
+    ConcurrentSet& operator=(const ConcurrentSet&) = delete;
+
+    /*
+     * Insert val into the Set
+     * Return true if val was inserted, false if it already belonged to the Set
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val from the Set
+     * Return true if val was removed, false if it did not belong to the Set
+     */
+    bool erase(int val);
+
+    /*
+     * Test whether val belongs to the Set
+     * The values of the Set are not modified, but an insertion or removal of val in progress
+     * may be stamped to take effect
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Return a copy of the Set as it was at a single instant (linearizable snapshot)
+     * A single walk of the list, which neither waits for nor blocks insertions and removals
+     */
+    Set snapshot() const;
+
+    /*
+     * Insert all elements of Set S, each insertion is atomic but the union as a whole is not
+     */
+    ConcurrentSet& operator+=(const Set& S);
+
+    /*
+     * Remove all elements that do not belong to Set S, each removal is atomic
+     */
+    ConcurrentSet& operator*=(const Set& S);
+
+    /*
+     * Remove all elements of Set S, each removal is atomic
+     */
+    ConcurrentSet& operator-=(const Set& S);
+
+private:
+    struct Node {
+        int value;
+        std::atomic<std::uintptr_t> next;        // pointer to the next Node, lowest bit marks this Node as removed
+        std::atomic<std::uint64_t> inserted{0};  // version at which the insertion took effect, 0 until then
+        std::atomic<std::uint64_t> removed{0};   // version at which the removal took effect, 0 until then
+    };
+
+    class Epochs;  // epoch-based reclamation, defined in concurrent_set.cpp
+    class Guard;   // marks the calling thread as reading the list, defined in concurrent_set.cpp
+
+    /*
+     * Position in the list: link points to the first Node with value >= val, or to nullptr
+     */
+    struct Window {
+        std::atomic<std::uintptr_t>* link;  // next field of the predecessor (or head)
+        Node* curr;                         // first Node with value >= val, or nullptr
+    };
+
+    std::atomic<std::uintptr_t> head{0};  // pointer to the first Node
+
+    mutable std::atomic<std::uint64_t> version{1};  // advanced by every snapshot
+    mutable std::atomic<unsigned> snapshots{0};     // number of snapshots in progress
+    mutable std::atomic<Node*> reports{nullptr};    // copies of the Nodes unlinked during snapshots
+
+    /*
+     * Return the version of stamp s, setting it to the current version first if it is 0
+     */
+    std::uint64_t stamp(std::atomic<std::uint64_t>& s) const;
+
+    /*
+     * Report Node p, about to be unlinked, to the snapshots in progress if any
+     * p must be stamped as removed
+     */
+    void report_unlink(const Node* p);
+
+    /*
+     * Find the position of val, unlinking the marked Nodes on the way
+     * The caller must hold a Guard
+     */
+    Window find(int val);
+};
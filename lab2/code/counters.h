@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/** Class NodeCounters
+ *
+ * Instrumentation counters for the Nodes of all Sets, safe to update from several threads
+ * Each thread updates its own shard (cache line) with relaxed atomics, so the threads do not
+ * contend on a shared counter; reading a counter adds up all the shards
+ *
+ * All members are static, the class is never instantiated
+ */
+class NodeCounters {
+public:
+    enum Counter {
+        live_nodes,          // number of existing Nodes
+        allocations,         // number of Nodes allocated on the heap so far
+        bytes,               // number of bytes allocated on the heap for Nodes so far
+        peak_live_nodes,     // high-water mark of live_nodes
+        union_steps,         // merge steps executed by Set::operator+=
+        intersection_steps,  // merge steps executed by Set::operator*=
+        difference_steps,    // merge steps executed by Set::operator-=
+        n_counters
+    };
+
+    /*
+     * Add n to counter c of the calling thread's shard
+     */
+    static void add(Counter c, long long n) {
+        local().values[c].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /*
+     * A Node was constructed: update live_nodes and peak_live_nodes
+     * The peak is exact for a single thread, and an upper bound (sum of the shard peaks)
+     * when Nodes are created and destroyed from several threads
+     */
+    static void node_created() {
+        Shard& s = local();
+        const long long live = s.values[live_nodes].fetch_add(1, std::memory_order_relaxed) + 1;
+        if (live > s.values[peak_live_nodes].load(std::memory_order_relaxed)) {
+            s.values[peak_live_nodes].store(live, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * A Node was destroyed
+     */
+    static void node_destroyed() {
+        add(live_nodes, -1);
+    }
+
+    /*
+     * size bytes were allocated on the heap for a Node
+     */
+    static void node_allocated(std::size_t size) {
+        Shard& s = local();
+        s.values[allocations].fetch_add(1, std::memory_order_relaxed);
+        s.values[bytes].fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    }
+
+    /*
+     * Return the value of counter c, aggregated over all shards
+     */
+    static long long total(Counter c) {
+        long long sum = 0;
+        for (const Shard& s : shards) {
+            sum += s.values[c].load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+private:
+    static constexpr std::size_t n_shards = 64;  // threads beyond 64 share shards round-robin
+
+    struct alignas(64) Shard {
+        std::array<std::atomic<long long>, n_counters> values{};
+    };
+
+    static std::array<Shard, n_shards> shards;
+    static std::atomic<std::size_t> next_shard;
+
+    /*
+     * Return the shard of the calling thread, assigned on its first use
+     */
+    static Shard& local() {
+        thread_local Shard& s = shards[next_shard.fetch_add(1, std::memory_order_relaxed) % n_shards];
+        return s;
+    }
+};
+
+inline std::array<NodeCounters::Shard, NodeCounters::n_shards> NodeCounters::shards{};
+inline std::atomic<std::size_t> NodeCounters::next_shard{0};
@@ -0,0 +1,316 @@
+#include "cow_set.h"
+#include "set_merge.h"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
+
+/*****************************************************
+ * Construction                                       *
+ ******************************************************/
+
+/*
+ * Default constructor: create an empty CowSet
+ * All empty CowSets share one empty chunk, which is copied when it is first modified
+ */
+CowSet::CowSet() {
+    static const std::shared_ptr<Node> empty = std::make_shared<Node>();
+    root = empty;
+}
+
+/*
+ * Create a CowSet storing the values of Set S
+ */
+CowSet::CowSet(const Set& S) : CowSet{std::vector<int>(S.begin(), S.end())} {
+}
+
+/*
+ * Create a CowSet storing the sorted unique ints in values
+ * The values are cut into full chunks, then each level of branches groups
+ * branch_capacity nodes of the level below, until a single root is left
+ */
+CowSet::CowSet(std::span<const int> values) : CowSet{} {
+    std::vector<std::shared_ptr<Node>> level;
+    for (size_t i = 0; i < values.size(); i += chunk_capacity) {
+        const auto chunk = values.subspan(i, std::min(chunk_capacity, values.size() - i));
+        auto leaf = std::make_shared<Node>();
+        leaf->values.assign(chunk.begin(), chunk.end());
+        leaf->count = chunk.size();
+        leaf->max = chunk.back();
+        level.push_back(std::move(leaf));
+    }
+
+    while (level.size() > 1) {
+        std::vector<std::shared_ptr<Node>> parents;
+        for (size_t i = 0; i < level.size(); i += branch_capacity) {
+            auto branch = std::make_shared<Node>();
+            const size_t n = std::min(branch_capacity, level.size() - i);
+            for (size_t k = i; k < i + n; ++k) {
+                branch->count += level[k]->count;
+                branch->children.push_back(std::move(level[k]));
+            }
+            branch->max = branch->children.back()->max;
+            parents.push_back(std::move(branch));
+        }
+        level = std::move(parents);
+    }
+
+    if (!level.empty()) {
+        root = std::move(level.front());
+    }
+}
+
+/*****************************************************
+ * Queries                                            *
+ ******************************************************/
+
+/*
+ * Test whether val belongs to the Set
+ */
+bool CowSet::is_member(int val) const {
+    if (is_empty() || val > root->max) {
+        return false;
+    }
+
+    const Node* n = root.get();
+    while (!n->is_leaf()) {
+        n = n->children[child_index(*n, val)].get();
+    }
+    return std::ranges::binary_search(n->values, val);
+}
+
+CowSet::const_iterator CowSet::begin() const {
+    const_iterator it{};
+    it.root = root.get();
+    if (!is_empty()) {
+        it.chunk = chunk_at(it.root, 0, it.pos);
+    }
+    return it;
+}
+
+CowSet::const_iterator CowSet::end() const {
+    const_iterator it{};
+    it.root = root.get();
+    it.index = root->count;
+    return it;
+}
+
+/*
+ * Return the number of nodes of the spine of *this also used by C
+ */
+size_t CowSet::nodes_shared_with(const CowSet& C) const {
+    std::unordered_set<const Node*> nodes_of_c;
+    std::vector<const Node*> stack{C.root.get()};
+    while (!stack.empty()) {
+        const Node* n = stack.back();
+        stack.pop_back();
+        nodes_of_c.insert(n);
+        for (const auto& child : n->children) {
+            stack.push_back(child.get());
+        }
+    }
+
+    size_t shared = 0;
+    stack.push_back(root.get());
+    while (!stack.empty()) {
+        const Node* n = stack.back();
+        stack.pop_back();
+        if (nodes_of_c.contains(n)) {
+            ++shared;
+        }
+        for (const auto& child : n->children) {
+            stack.push_back(child.get());
+        }
+    }
+    return shared;
+}
+
+/*
+ * Create a Set with the values of the CowSet
+ */
+Set CowSet::to_set() const {
+    return Set{std::vector<int>(begin(), end())};
+}
+
+bool CowSet::operator==(const CowSet& C) const {
+    return root == C.root || (cardinality() == C.cardinality() && std::ranges::equal(*this, C));
+}
+
+/*****************************************************
+ * Modifications                                      *
+ ******************************************************/
+
+/*
+ * Insert val, return false if it already belonged to the Set
+ * If the root is split, a new root branch gets the two halves
+ */
+bool CowSet::insert(int val) {
+    if (is_member(val)) {
+        return false;
+    }
+
+    if (std::shared_ptr<Node> upper = insert_into(root, val)) {
+        auto branch = std::make_shared<Node>();
+        branch->count = root->count + upper->count;
+        branch->max = upper->max;
+        branch->children.push_back(std::move(root));
+        branch->children.push_back(std::move(upper));
+        root = std::move(branch);
+    }
+    return true;
+}
+
+/*
+ * Remove val, return false if it did not belong to the Set
+ * A root branch left with a single subtree is replaced by that subtree
+ */
+bool CowSet::erase(int val) {
+    if (!is_member(val)) {
+        return false;
+    }
+
+    erase_from(root, val);
+    while (root->children.size() == 1) {
+        root = root->children.front();
+    }
+    return true;
+}
+
+CowSet& CowSet::operator+=(const CowSet& C) {
+    *this = CowSet{merge_sorted(*this, C, keep_union)};
+    return *this;
+}
+
+CowSet& CowSet::operator*=(const CowSet& C) {
+    *this = CowSet{merge_sorted(*this, C, keep_intersection)};
+    return *this;
+}
+
+CowSet& CowSet::operator-=(const CowSet& C) {
+    *this = CowSet{merge_sorted(*this, C, keep_difference)};
+    return *this;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Make node p owned by *this only, copying it if it is shared
+ * Copying a branch copies the pointers to its subtrees, which become shared by both copies,
+ * so the next level of the path is copied in turn: only the path to the modified chunk is copied
+ * use_count() is a relaxed load: the acquire fence orders the in-place modifications after
+ * the reads done through copies that were destroyed by other threads, since shared_ptr
+ * releases its count with a release (acq_rel) decrement
+ */
+CowSet::Node& CowSet::own(std::shared_ptr<Node>& p) {
+    if (p.use_count() > 1) {
+        p = std::make_shared<Node>(*p);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return *p;
+}
+
+/*
+ * Insert val in the subtree p, return the new right sibling of p if p was split
+ */
+std::shared_ptr<CowSet::Node> CowSet::insert_into(std::shared_ptr<Node>& p, int val) {
+    Node& n = own(p);
+    ++n.count;
+
+    if (n.is_leaf()) {
+        n.values.insert(std::ranges::upper_bound(n.values, val), val);
+        n.max = n.values.back();
+        return (n.values.size() > chunk_capacity) ? split(n) : nullptr;
+    }
+
+    const size_t i = child_index(n, val);  // a value larger than all values goes to the last subtree
+    if (std::shared_ptr<Node> upper = insert_into(n.children[i], val)) {
+        n.children.insert(n.children.begin() + static_cast<std::ptrdiff_t>(i) + 1, std::move(upper));
+    }
+    n.max = n.children.back()->max;
+    return (n.children.size() > branch_capacity) ? split(n) : nullptr;
+}
+
+/*
+ * Remove val from the subtree p, and the subtree of p that becomes empty, if any
+ */
+void CowSet::erase_from(std::shared_ptr<Node>& p, int val) {
+    Node& n = own(p);
+    --n.count;
+
+    if (n.is_leaf()) {
+        n.values.erase(std::ranges::lower_bound(n.values, val));
+        if (!n.values.empty()) {
+            n.max = n.values.back();
+        }
+        return;
+    }
+
+    const size_t i = child_index(n, val);
+    erase_from(n.children[i], val);
+    if (n.children[i]->count == 0) {
+        n.children.erase(n.children.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    if (!n.children.empty()) {
+        n.max = n.children.back()->max;
+    }
+}
+
+/*
+ * Move the upper half of the values or subtrees of node n to a new node
+ */
+std::shared_ptr<CowSet::Node> CowSet::split(Node& n) {
+    auto upper = std::make_shared<Node>();
+
+    if (n.is_leaf()) {
+        const auto half = n.values.begin() + static_cast<std::ptrdiff_t>(n.values.size() / 2);
+        upper->values.assign(half, n.values.end());
+        n.values.erase(half, n.values.end());
+        upper->count = upper->values.size();
+        upper->max = upper->values.back();
+        n.max = n.values.back();
+    } else {
+        const auto half = n.children.begin() + static_cast<std::ptrdiff_t>(n.children.size() / 2);
+        upper->children.assign(std::make_move_iterator(half), std::make_move_iterator(n.children.end()));
+        n.children.erase(half, n.children.end());
+        for (const auto& child : upper->children) {
+            upper->count += child->count;
+        }
+        upper->max = upper->children.back()->max;
+        n.max = n.children.back()->max;
+    }
+
+    n.count -= upper->count;
+    return upper;
+}
+
+/*
+ * Return the index of the first subtree of branch n whose largest value is >= val,
+ * or of the last subtree if val is larger than all values
+ */
+size_t CowSet::child_index(const Node& n, int val) {
+    const auto it = std::ranges::lower_bound(n.children, val, {}, [](const std::shared_ptr<Node>& c) {
+        return c->max;
+    });
+    return std::min(static_cast<size_t>(it - n.children.begin()), n.children.size() - 1);
+}
+
+/*
+ * Return the chunk storing the value of index index in the subtree root: the counts of the
+ * subtrees of each branch on the path are added until index is reached
+ */
+const CowSet::Node* CowSet::chunk_at(const Node* root, size_t index, size_t& pos) {
+    const Node* n = root;
+    while (!n->is_leaf()) {
+        for (const auto& child : n->children) {
+            if (index < child->count) {
+                n = child.get();
+                break;
+            }
+            index -= child->count;
+        }
+    }
+    pos = index;
+    return n;
+}
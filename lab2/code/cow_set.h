@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "set.h"
+
+/** Class to represent a Set of ints with O(1) copies
+ *
+ * CowSet stores its values in sorted chunks of at most chunk_capacity ints, which are the
+ * leaves of a B-tree (the spine): each branch holds at most branch_capacity subtrees,
+ * and every node knows the number and the largest of the values below it
+ * The nodes are shared by all copies of a CowSet (copy-on-write), so copying a CowSet
+ * only copies one pointer
+ *
+ * insert and erase copy the path from the root to the affected chunk, unless its nodes are
+ * not shared, in which case they are modified in place: O(branch_capacity * log n) pointers
+ * and one chunk, whatever the size of the Set
+ * Chunks and branches that become empty are removed, they are not merged with their neighbours
+ * Different copies of a CowSet can be read and modified concurrently by different threads,
+ * but a CowSet object must not be modified while another thread uses the same object
+ */
+class CowSet {
+    struct Node {
+        std::vector<int> values;                      // leaf (chunk): sorted, at most chunk_capacity values
+        std::vector<std::shared_ptr<Node>> children;  // branch: sorted subtrees, empty for a leaf
+        size_t count{0};                              // number of values in the subtree
+        int max{0};                                   // largest value in the subtree, if count > 0
+
+        bool is_leaf() const {
+            return children.empty();
+        }
+    };
+
+public:
+    static constexpr size_t chunk_capacity = 64;   // maximum number of values in a chunk
+    static constexpr size_t branch_capacity = 32;  // maximum number of subtrees of a branch
+
+    /*
+     * Forward iterator over the values of a CowSet, in increasing order
+     * Moving to the next chunk descends from the root by the counts of the subtrees
+     * Invalidated by any modification of the CowSet
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return chunk->values[pos];
+        }
+
+        const_iterator& operator++() {
+            ++index;
+            if (++pos == chunk->values.size() && index < root->count) {
+                chunk = chunk_at(root, index, pos);
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator it{*this};
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& it) const {
+            return index == it.index;
+        }
+
+    private:
+        friend class CowSet;
+
+        const Node* root{nullptr};
+        const Node* chunk{nullptr};  // chunk storing the value
+        size_t pos{0};               // index of the value in the chunk
+        size_t index{0};             // index of the value in the Set, cardinality() for end()
+    };
+
+    /*
+     * Default constructor: create an empty CowSet
+     */
+    CowSet();
+
+    /*
+     * Create a CowSet storing the values of Set S
+     */
+    explicit CowSet(const Set& S);
+
+    /*
+     * Create a CowSet storing the sorted unique ints in values
+     */
+    explicit CowSet(std::span<const int> values);
+
+    /*
+     * Copy constructor and assignment: O(1), the copies share the spine and the chunks
+     * There are no move operations, so that a CowSet is never left without a root
+     */
+    CowSet(const CowSet& C) = default;
+    CowSet& operator=(const CowSet& C) = default;
+
+    size_t cardinality() const {
+        return root->count;
+    }
+
+    bool is_empty() const {
+        return root->count == 0;
+    }
+
+    /*
+     * Test whether val belongs to the Set: binary searches in the branches, then in one chunk
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Insert val, return false if it already belonged to the Set
+     * Copy the path to the chunk where val is inserted, as far as it is shared with other copies
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val, return false if it did not belong to the Set
+     * Copy the path to the chunk where val is removed, as far as it is shared with other copies
+     */
+    bool erase(int val);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Test whether *this and C share their storage, i.e. one is an unmodified copy of the other
+     */
+    bool shares_storage_with(const CowSet& C) const {
+        return root == C.root;
+    }
+
+    /*
+     * Return the number of nodes of the spine (branches and chunks) of *this also used by C
+     * nodes_shared_with(*this) is the number of nodes of the spine
+     */
+    size_t nodes_shared_with(const CowSet& C) const;
+
+    /*
+     * Create a Set with the values of the CowSet
+     */
+    Set to_set() const;
+
+    bool operator==(const CowSet& C) const;
+
+    /*
+     * Union, intersection and difference: a single merge, which rebuilds the chunks
+     */
+    CowSet& operator+=(const CowSet& C);
+    CowSet& operator*=(const CowSet& C);
+    CowSet& operator-=(const CowSet& C);
+
+    friend CowSet operator+(CowSet C1, const CowSet& C2) {
+        return (C1 += C2);
+    }
+
+    friend CowSet operator*(CowSet C1, const CowSet& C2) {
+        return (C1 *= C2);
+    }
+
+    friend CowSet operator-(CowSet C1, const CowSet& C2) {
+        return (C1 -= C2);
+    }
+
+private:
+    std::shared_ptr<Node> root;  // a chunk, or a branch with at least one subtree
+
+    /*
+     * Make node p owned by *this only, copying it if it is shared, and return it
+     */
+    static Node& own(std::shared_ptr<Node>& p);
+
+    /*
+     * Insert val, which does not belong to the Set, in the subtree p
+     * Return the new right sibling of p if p was split, nullptr otherwise
+     */
+    static std::shared_ptr<Node> insert_into(std::shared_ptr<Node>& p, int val);
+
+    /*
+     * Remove val, which belongs to the Set, from the subtree p
+     */
+    static void erase_from(std::shared_ptr<Node>& p, int val);
+
+    /*
+     * Move the upper half of the values or subtrees of node n to a new node, and return it
+     */
+    static std::shared_ptr<Node> split(Node& n);
+
+    /*
+     * Return the index of the subtree of branch n where val belongs, or would be inserted
+     */
+    static size_t child_index(const Node& n, int val);
+
+    /*
+     * Return the chunk storing the value of index index in the subtree root,
+     * and set pos to the index of the value in the chunk
+     */
+    static const Node* chunk_at(const Node* root, size_t index, size_t& pos);
+};
@@ -0,0 +1,251 @@
+#include "frozen_set.h"
+#include "set_merge.h"
+
+#include <bit>
+
+/*****************************************************
+ * Construction                                       *
+ ******************************************************/
+
+/*
+ * Create a FrozenSet storing the values of Set S
+ */
+FrozenSet::FrozenSet(const Set& S) {
+    if (!S.is_empty()) {
+        encode(S.begin(), S.cardinality(), *std::prev(S.end()));
+    }
+}
+
+/*
+ * Create a FrozenSet storing the sorted unique ints in values
+ */
+FrozenSet::FrozenSet(std::span<const int> values) {
+    if (!values.empty()) {
+        encode(values.begin(), values.size(), values.back());
+    }
+}
+
+/*
+ * Encode the count sorted unique ints starting at first, the largest of which is max
+ */
+template <typename InputIt>
+void FrozenSet::encode(InputIt first, size_t count, int max) {
+    n = count;
+    min = *first;
+
+    const std::uint64_t u = static_cast<std::uint64_t>(std::int64_t{max} - min + 1);
+    l = (u > n) ? static_cast<unsigned>(std::bit_width(u / n) - 1) : 0;
+
+    const std::uint64_t max_high = (u - 1) >> l;
+    high_size = n + max_high + 1;
+    low.assign((n * l + 63) / 64 + 1, 0);  // one extra word to read the low bits with two loads
+    high.assign((high_size + 63) / 64, 0);
+
+    for (size_t i = 0; i < n; ++i, ++first) {
+        const std::uint64_t v = static_cast<std::uint32_t>(*first) - static_cast<std::uint32_t>(min);
+
+        if (l > 0) {
+            const std::uint64_t bit = i * l;
+            const std::uint64_t bits = v & ((std::uint64_t{1} << l) - 1);
+            low[bit / 64] |= bits << (bit % 64);
+            if (bit % 64 + l > 64) {
+                low[bit / 64 + 1] |= bits >> (64 - bit % 64);
+            }
+        }
+
+        const std::uint64_t p = (v >> l) + i;
+        high[p / 64] |= std::uint64_t{1} << (p % 64);
+    }
+
+    std::uint64_t zeros = 0;
+    for (std::uint64_t p = 0; p < high_size; ++p) {
+        if (((high[p / 64] >> (p % 64)) & 1) == 0) {
+            if (zeros % zero_sample_rate == 0) {
+                zero_samples.push_back(p);
+            }
+            ++zeros;
+        }
+    }
+}
+
+/*****************************************************
+ * Queries                                            *
+ ******************************************************/
+
+/*
+ * Test whether val belongs to the Set
+ */
+bool FrozenSet::is_member(int val) const {
+    if (n == 0 || val < min) {
+        return false;
+    }
+
+    const std::uint64_t v = static_cast<std::uint32_t>(val) - static_cast<std::uint32_t>(min);
+    const std::uint64_t h = v >> l;
+    const std::uint64_t bits = v & ((std::uint64_t{1} << l) - 1);
+
+    // Bucket h starts right after the zero number h-1
+    std::uint64_t p = (h == 0) ? 0 : select_zero(h - 1) + 1;
+    if (p >= high_size) {
+        return false;  // val > max
+    }
+
+    for (size_t i = p - h; p < high_size && ((high[p / 64] >> (p % 64)) & 1) != 0; ++p, ++i) {
+        const std::uint64_t b = low_bits(i);
+        if (b >= bits) {
+            return b == bits;
+        }
+    }
+    return false;
+}
+
+FrozenSet::const_iterator FrozenSet::begin() const {
+    const_iterator it{};
+    it.set = this;
+    if (n > 0) {
+        it.pos = next_one(0);
+        it.decode();
+    }
+    return it;
+}
+
+FrozenSet::const_iterator FrozenSet::end() const {
+    const_iterator it{};
+    it.set = this;
+    it.index = n;
+    return it;
+}
+
+FrozenSet::const_iterator& FrozenSet::const_iterator::operator++() {
+    if (++index < set->n) {
+        pos = set->next_one(pos + 1);
+        decode();
+    }
+    return *this;
+}
+
+/*
+ * Compute value from the high bits at pos and the low bits of index
+ */
+void FrozenSet::const_iterator::decode() {
+    const std::uint64_t v = ((pos - index) << set->l) | set->low_bits(index);
+    value = static_cast<int>(static_cast<std::uint32_t>(set->min) + static_cast<std::uint32_t>(v));
+}
+
+/*
+ * Decode the FrozenSet into a Set
+ */
+Set FrozenSet::to_set() const {
+    return Set{std::vector<int>(begin(), end())};
+}
+
+/*
+ * Return the number of bytes used by the FrozenSet, including its heap storage
+ */
+size_t FrozenSet::memory_bytes() const {
+    return sizeof(*this) +
+           sizeof(std::uint64_t) * (low.capacity() + high.capacity() + zero_samples.capacity());
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Return the low bits of value i
+ */
+std::uint64_t FrozenSet::low_bits(size_t i) const {
+    if (l == 0) {
+        return 0;
+    }
+
+    const std::uint64_t bit = i * l;
+    std::uint64_t bits = low[bit / 64] >> (bit % 64);
+    if (bit % 64 + l > 64) {
+        bits |= low[bit / 64 + 1] << (64 - bit % 64);
+    }
+    return bits & ((std::uint64_t{1} << l) - 1);
+}
+
+/*
+ * Return the position in high of the zero number z (counting from 0)
+ * Start from the closest sample, then count the zeros of whole words with popcount
+ */
+std::uint64_t FrozenSet::select_zero(std::uint64_t z) const {
+    const std::uint64_t sample = z / zero_sample_rate;
+    if (sample >= zero_samples.size()) {
+        return high_size;  // there are fewer zeros than z+1
+    }
+
+    std::uint64_t p = zero_samples[sample];
+    std::uint64_t remaining = z - sample * zero_sample_rate;  // zeros to skip after the one at p
+
+    std::uint64_t w = p / 64;
+    std::uint64_t zeros = ~high[w] & (~std::uint64_t{0} << (p % 64));
+    while (true) {
+        const auto count = static_cast<std::uint64_t>(std::popcount(zeros));
+        if (remaining < count) {
+            for (; remaining > 0; --remaining) {
+                zeros &= zeros - 1;  // clear the lowest zero
+            }
+            return w * 64 + static_cast<std::uint64_t>(std::countr_zero(zeros));
+        }
+        remaining -= count;
+        if (++w == high.size()) {
+            return high_size;
+        }
+        zeros = ~high[w];
+    }
+}
+
+/*
+ * Return the position in high of the first one at or after position p
+ */
+std::uint64_t FrozenSet::next_one(std::uint64_t p) const {
+    std::uint64_t w = p / 64;
+    std::uint64_t ones = high[w] & (~std::uint64_t{0} << (p % 64));
+    while (ones == 0) {
+        ones = high[++w];
+    }
+    return w * 64 + static_cast<std::uint64_t>(std::countr_zero(ones));
+}
+
+/*****************************************************
+ * Set operations                                     *
+ ******************************************************/
+
+Set operator+(const FrozenSet& F, const Set& S) {
+    return Set{merge_sorted(F, S, keep_union)};
+}
+
+Set operator+(const Set& S, const FrozenSet& F) {
+    return F + S;
+}
+
+Set operator*(const FrozenSet& F, const Set& S) {
+    return Set{merge_sorted(F, S, keep_intersection)};
+}
+
+Set operator*(const Set& S, const FrozenSet& F) {
+    return F * S;
+}
+
+Set operator-(const FrozenSet& F, const Set& S) {
+    return Set{merge_sorted(F, S, keep_difference)};
+}
+
+Set operator-(const Set& S, const FrozenSet& F) {
+    return Set{merge_sorted(S, F, keep_difference)};
+}
+
+FrozenSet operator+(const FrozenSet& F1, const FrozenSet& F2) {
+    return FrozenSet{merge_sorted(F1, F2, keep_union)};
+}
+
+FrozenSet operator*(const FrozenSet& F1, const FrozenSet& F2) {
+    return FrozenSet{merge_sorted(F1, F2, keep_intersection)};
+}
+
+FrozenSet operator-(const FrozenSet& F1, const FrozenSet& F2) {
+    return FrozenSet{merge_sorted(F1, F2, keep_difference)};
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "set.h"
+
+/** Class to represent an immutable, compressed Set of ints
+ *
+ * FrozenSet stores its n values, shifted to [0, u) where u = max - min + 1, with Elias-Fano encoding
+ *   the l = floor(log2(u/n)) low bits of every value are stored in a packed bit array
+ *   the high bits are stored in unary in a bit vector of n + u/2^l bits
+ * which takes about 2 + log2(u/n) bits per value, instead of a Set::Node per value
+ *
+ * A sample of the positions of the zeros in the high bits lets is_member jump directly
+ * to the bucket of its argument, the values are otherwise decoded sequentially by the iterator
+ */
+class FrozenSet {
+public:
+    /*
+     * Forward iterator decoding the values of the FrozenSet, in increasing order
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return value;
+        }
+
+        const_iterator& operator++();
+        const_iterator operator++(int) {
+            const_iterator it{*this};
+            ++*this;
+            return it;
+        }
+
+        // Two iterators of the same FrozenSet are equal when they refer to the same value
+        bool operator==(const const_iterator& it) const {
+            return index == it.index;
+        }
+
+    private:
+        friend class FrozenSet;
+
+        const FrozenSet* set{nullptr};
+        size_t index{0};       // index of value among the values of the FrozenSet
+        std::uint64_t pos{0};  // position of the one bit of value in the high bits
+        int value{0};
+
+        void decode();
+    };
+
+    /*
+     * Default constructor: create an empty FrozenSet
+     */
+    FrozenSet() = default;
+
+    /*
+     * Create a FrozenSet storing the values of Set S
+     */
+    explicit FrozenSet(const Set& S);
+
+    /*
+     * Create a FrozenSet storing the sorted unique ints in values
+     */
+    explicit FrozenSet(std::span<const int> values);
+
+    size_t cardinality() const {
+        return n;
+    }
+
+    bool is_empty() const {
+        return n == 0;
+    }
+
+    /*
+     * Test whether val belongs to the Set
+     * Jump to the bucket of the high bits of val, then compare the low bits of the bucket
+     */
+    bool is_member(int val) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Decode the FrozenSet into a Set
+     */
+    Set to_set() const;
+
+    /*
+     * Return the number of bytes used by the FrozenSet, including its heap storage
+     */
+    size_t memory_bytes() const;
+
+    /*
+     * The encoding of a set of values is unique, so equal encodings represent equal Sets
+     */
+    bool operator==(const FrozenSet& F) const = default;
+
+private:
+    static constexpr std::uint64_t zero_sample_rate = 256;  // zeros of the high bits between two samples
+
+    size_t n{0};                              // number of values
+    int min{0};                               // smallest value, all values are stored as value - min
+    unsigned l{0};                            // number of low bits per value
+    std::uint64_t high_size{0};               // number of bits in high
+    std::vector<std::uint64_t> low;           // packed low bits, l bits per value
+    std::vector<std::uint64_t> high;          // high bits in unary: bit (v >> l) + i is set for value i
+    std::vector<std::uint64_t> zero_samples;  // position in high of every zero_sample_rate-th zero
+
+    /*
+     * Encode the count sorted unique ints starting at first, the largest of which is max
+     */
+    template <typename InputIt>
+    void encode(InputIt first, size_t count, int max);
+
+    /*
+     * Return the low bits of value i
+     */
+    std::uint64_t low_bits(size_t i) const;
+
+    /*
+     * Return the position in high of the zero number z (counting from 0)
+     */
+    std::uint64_t select_zero(std::uint64_t z) const;
+
+    /*
+     * Return the position in high of the first one at or after position p
+     */
+    std::uint64_t next_one(std::uint64_t p) const;
+};
+
+/*
+ * Set operations with a FrozenSet, computed with a single merge over the decoded values
+ */
+Set operator+(const FrozenSet& F, const Set& S);
+Set operator+(const Set& S, const FrozenSet& F);
+Set operator*(const FrozenSet& F, const Set& S);
+Set operator*(const Set& S, const FrozenSet& F);
+Set operator-(const FrozenSet& F, const Set& S);
+Set operator-(const Set& S, const FrozenSet& F);
+
+FrozenSet operator+(const FrozenSet& F1, const FrozenSet& F2);
+FrozenSet operator*(const FrozenSet& F1, const FrozenSet& F2);
+FrozenSet operator-(const FrozenSet& F1, const FrozenSet& F2);
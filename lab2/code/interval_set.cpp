@@ -0,0 +1,289 @@
+#include "interval_set.h"
+
+#include <algorithm>
+#include <cstdint>
+
+/*****************************************************
+ * Construction                                       *
+ ******************************************************/
+
+/*
+ * Create the IntervalSet [lo, hi], empty if lo > hi
+ */
+IntervalSet::IntervalSet(int lo, int hi) {
+    if (lo <= hi) {
+        runs.push_back(Interval{lo, hi});
+    }
+}
+
+/*
+ * Create an IntervalSet storing the values of Set S
+ */
+IntervalSet::IntervalSet(const Set& S) {
+    for (int val : S) {
+        append(val, val);
+    }
+}
+
+/*
+ * Create an IntervalSet storing the sorted unique ints in values
+ */
+IntervalSet::IntervalSet(std::span<const int> values) {
+    for (int val : values) {
+        append(val, val);
+    }
+}
+
+/*
+ * Return an IntervalSet storing the values of S if they form long enough runs
+ */
+std::optional<IntervalSet> IntervalSet::compress(const Set& S) {
+    IntervalSet I{S};
+    if (!S.is_empty() && I.is_fragmented()) {
+        return std::nullopt;
+    }
+    return I;
+}
+
+/*****************************************************
+ * Queries                                            *
+ ******************************************************/
+
+/*
+ * Test whether the runs are too short on average to be worth storing
+ */
+bool IntervalSet::is_fragmented() const {
+    return static_cast<double>(cardinality()) < min_average_run * static_cast<double>(runs.size());
+}
+
+/*
+ * Return the number of values in the Set
+ */
+size_t IntervalSet::cardinality() const {
+    size_t n = 0;
+    for (const Interval& r : runs) {
+        n += static_cast<size_t>(std::int64_t{r.hi} - r.lo + 1);
+    }
+    return n;
+}
+
+/*
+ * Test whether val belongs to the Set
+ */
+bool IntervalSet::is_member(int val) const {
+    // First run starting after val: val can only belong to the run before it
+    const auto it = std::ranges::upper_bound(runs, val, {}, &Interval::lo);
+    return it != runs.begin() && val <= std::prev(it)->hi;
+}
+
+IntervalSet::const_iterator IntervalSet::begin() const {
+    const_iterator it{};
+    it.runs = &runs;
+    it.value = runs.empty() ? 0 : runs.front().lo;
+    return it;
+}
+
+IntervalSet::const_iterator IntervalSet::end() const {
+    const_iterator it{};
+    it.runs = &runs;
+    it.run = runs.size();
+    return it;
+}
+
+IntervalSet::const_iterator& IntervalSet::const_iterator::operator++() {
+    if (value < (*runs)[run].hi) {
+        ++value;
+    } else {
+        ++run;
+        value = (run < runs->size()) ? (*runs)[run].lo : 0;
+    }
+    return *this;
+}
+
+/*
+ * Expand the runs into a Set
+ */
+Set IntervalSet::to_set() const {
+    return Set{std::vector<int>(begin(), end())};
+}
+
+/*
+ * Test whether every value of *this belongs to I
+ * Each run of *this must lie in a single run of I, since the runs of I are not adjacent
+ */
+bool IntervalSet::is_subset_of(const IntervalSet& I) const {
+    auto b = I.runs.begin();
+    for (const Interval& a : runs) {
+        while (b != I.runs.end() && b->hi < a.lo) {
+            ++b;
+        }
+        if (b == I.runs.end() || b->lo > a.lo || b->hi < a.hi) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Three-way comparison operator: set inclusion
+ */
+std::partial_ordering IntervalSet::operator<=>(const IntervalSet& I) const {
+    if (*this == I) {
+        return std::partial_ordering::equivalent;
+    }
+    if (is_subset_of(I)) {
+        return std::partial_ordering::less;
+    }
+    return I.is_subset_of(*this) ? std::partial_ordering::greater : std::partial_ordering::unordered;
+}
+
+std::ostream& operator<<(std::ostream& os, const IntervalSet& I) {
+    if (I.is_empty()) {
+        return os << "Set is empty!";
+    }
+    os << "{ ";
+    for (const IntervalSet::Interval& r : I.runs) {
+        os << "[" << r.lo << ", " << r.hi << "] ";
+    }
+    return os << "}";
+}
+
+/*****************************************************
+ * Modifications                                      *
+ ******************************************************/
+
+/*
+ * Insert all values in [lo, hi], merging the runs they overlap or touch
+ */
+void IntervalSet::insert(int lo, int hi) {
+    if (lo <= hi) {
+        *this += IntervalSet{lo, hi};
+    }
+}
+
+/*
+ * Insert val, return false if it already belonged to the Set
+ */
+bool IntervalSet::insert(int val) {
+    if (is_member(val)) {
+        return false;
+    }
+    insert(val, val);
+    return true;
+}
+
+/*
+ * Remove val, return false if it did not belong to the Set
+ */
+bool IntervalSet::erase(int val) {
+    auto it = std::ranges::upper_bound(runs, val, {}, &Interval::lo);
+    if (it == runs.begin() || val > std::prev(it)->hi) {
+        return false;
+    }
+
+    Interval& r = *std::prev(it);
+    if (r.lo == r.hi) {
+        runs.erase(std::prev(it));
+    } else if (val == r.lo) {
+        ++r.lo;
+    } else if (val == r.hi) {
+        --r.hi;
+    } else {  // split the run
+        const Interval upper{val + 1, r.hi};
+        r.hi = val - 1;
+        runs.insert(it, upper);
+    }
+    return true;
+}
+
+/*
+ * Modify Set *this such that it becomes the union of *this with Set I
+ * Runs are taken in increasing order of lo from both Sets, and merged when they overlap or touch
+ */
+IntervalSet& IntervalSet::operator+=(const IntervalSet& I) {
+    IntervalSet R{};
+    R.runs.reserve(runs.size() + I.runs.size());
+    auto a = runs.begin();
+    auto b = I.runs.begin();
+
+    while (a != runs.end() || b != I.runs.end()) {
+        if (b == I.runs.end() || (a != runs.end() && a->lo <= b->lo)) {
+            R.append(a->lo, a->hi);
+            ++a;
+        } else {
+            R.append(b->lo, b->hi);
+            ++b;
+        }
+    }
+
+    runs = std::move(R.runs);
+    return *this;
+}
+
+/*
+ * Modify Set *this such that it becomes the intersection of *this with Set I
+ */
+IntervalSet& IntervalSet::operator*=(const IntervalSet& I) {
+    std::vector<Interval> result;
+    auto a = runs.begin();
+    auto b = I.runs.begin();
+
+    while (a != runs.end() && b != I.runs.end()) {
+        const int lo = std::max(a->lo, b->lo);
+        const int hi = std::min(a->hi, b->hi);
+        if (lo <= hi) {
+            result.push_back(Interval{lo, hi});
+        }
+        // The run ending first cannot overlap any later run of the other Set
+        if (a->hi < b->hi) {
+            ++a;
+        } else {
+            ++b;
+        }
+    }
+
+    runs = std::move(result);
+    return *this;
+}
+
+/*
+ * Modify Set *this such that it becomes the Set difference *this - I
+ */
+IntervalSet& IntervalSet::operator-=(const IntervalSet& I) {
+    std::vector<Interval> result;
+    auto b = I.runs.begin();
+
+    for (const Interval& a : runs) {
+        std::int64_t lo = a.lo;  // first value of a not yet removed or kept
+        while (b != I.runs.end() && b->hi < lo) {
+            ++b;
+        }
+        for (auto c = b; c != I.runs.end() && c->lo <= a.hi; ++c) {
+            if (c->lo > lo) {
+                result.push_back(Interval{static_cast<int>(lo), c->lo - 1});
+            }
+            lo = std::int64_t{c->hi} + 1;
+        }
+        if (lo <= a.hi) {
+            result.push_back(Interval{static_cast<int>(lo), a.hi});
+        }
+    }
+
+    runs = std::move(result);
+    return *this;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Append the run [lo, hi], merging it with the last run if they overlap or touch
+ */
+void IntervalSet::append(int lo, int hi) {
+    if (!runs.empty() && std::int64_t{lo} <= std::int64_t{runs.back().hi} + 1) {
+        runs.back().hi = std::max(runs.back().hi, hi);
+    } else {
+        runs.push_back(Interval{lo, hi});
+    }
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "set.h"
+
+/** Class to represent a Set of ints as a sorted vector of runs [lo, hi] of consecutive ints
+ *
+ * The runs are disjoint and not adjacent (there is at least one missing int between two runs),
+ * so every Set has a single representation
+ * A Set made of a few long runs, e.g. [1, 1000000] + [2000000, 3000000], takes a few bytes,
+ * and union, intersection, difference and comparisons run in O(number of runs)
+ *
+ * compress converts a Set to an IntervalSet when its values form long enough runs,
+ * and is_fragmented tells when an IntervalSet should be converted back with to_set
+ */
+class IntervalSet {
+public:
+    struct Interval {
+        int lo;  // smallest value of the run
+        int hi;  // largest value of the run, lo <= hi
+
+        bool operator==(const Interval&) const = default;
+    };
+
+    /*
+     * Minimum average number of values per run for which runs are preferred to a list of values
+     */
+    static constexpr double min_average_run = 4.0;
+
+    /*
+     * Forward iterator over the values of an IntervalSet, in increasing order
+     * Invalidated by any modification of the IntervalSet
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return value;
+        }
+
+        const_iterator& operator++();
+
+        const_iterator operator++(int) {
+            const_iterator it{*this};
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& it) const {
+            return run == it.run && value == it.value;
+        }
+
+    private:
+        friend class IntervalSet;
+
+        const std::vector<Interval>* runs{nullptr};
+        size_t run{0};  // index of the run, runs->size() for end()
+        int value{0};   // current value, 0 for end()
+    };
+
+    /*
+     * Default constructor: create an empty IntervalSet
+     */
+    IntervalSet() = default;
+
+    /*
+     * Create the IntervalSet [lo, hi], empty if lo > hi
+     */
+    IntervalSet(int lo, int hi);
+
+    /*
+     * Create an IntervalSet storing the values of Set S: O(n)
+     */
+    explicit IntervalSet(const Set& S);
+
+    /*
+     * Create an IntervalSet storing the sorted unique ints in values: O(n)
+     */
+    explicit IntervalSet(std::span<const int> values);
+
+    /*
+     * Return an IntervalSet storing the values of S if they form runs of min_average_run values
+     * on average, otherwise std::nullopt: S is better stored as a list of values
+     */
+    static std::optional<IntervalSet> compress(const Set& S);
+
+    /*
+     * Test whether the runs are too short on average to be worth storing: see min_average_run
+     */
+    bool is_fragmented() const;
+
+    /*
+     * Return the number of values in the Set (not the number of runs)
+     */
+    size_t cardinality() const;
+
+    bool is_empty() const {
+        return runs.empty();
+    }
+
+    /*
+     * Return the runs of the Set, in increasing order
+     */
+    std::span<const Interval> intervals() const {
+        return runs;
+    }
+
+    /*
+     * Test whether val belongs to the Set: binary search on the runs, O(log runs)
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Insert all values in [lo, hi] (nothing if lo > hi), merging the runs they overlap or touch
+     */
+    void insert(int lo, int hi);
+
+    /*
+     * Insert val, return false if it already belonged to the Set
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val, return false if it did not belong to the Set
+     * A run is split in two if val is neither its first nor its last value
+     */
+    bool erase(int val);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Expand the runs into a Set, one Node per value
+     */
+    Set to_set() const;
+
+    bool operator==(const IntervalSet& I) const = default;
+
+    /*
+     * Test whether every value of *this belongs to I: O(runs)
+     */
+    bool is_subset_of(const IntervalSet& I) const;
+
+    /*
+     * Three-way comparison operator: set inclusion, as for Set
+     */
+    std::partial_ordering operator<=>(const IntervalSet& I) const;
+
+    /*
+     * Union, intersection and difference: a single merge of the runs, O(runs)
+     */
+    IntervalSet& operator+=(const IntervalSet& I);
+    IntervalSet& operator*=(const IntervalSet& I);
+    IntervalSet& operator-=(const IntervalSet& I);
+
+    friend IntervalSet operator+(IntervalSet I1, const IntervalSet& I2) {
+        return (I1 += I2);
+    }
+
+    friend IntervalSet operator*(IntervalSet I1, const IntervalSet& I2) {
+        return (I1 *= I2);
+    }
+
+    friend IntervalSet operator-(IntervalSet I1, const IntervalSet& I2) {
+        return (I1 -= I2);
+    }
+
+    /*
+     * Write the runs: "Set is empty!" or "{ [1, 5] [7, 7] }"
+     */
+    friend std::ostream& operator<<(std::ostream& os, const IntervalSet& I);
+
+private:
+    std::vector<Interval> runs;  // sorted, disjoint and not adjacent
+
+    /*
+     * Append the run [lo, hi], which must not start before the last run
+     * It is merged with the last run if they overlap or touch
+     */
+    void append(int lo, int hi);
+};
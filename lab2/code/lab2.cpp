@@ -4,6 +4,24 @@
 #include <cassert>
 
 #include "set.h"
+#include "concurrent_set.h"
+#include "set_io.h"
+#include "frozen_set.h"
+#include "parallel_merge.h"
+#include "cow_set.h"
+#include "small_set.h"
+#include "unrolled_set.h"
+#include "pool_set.h"
+#include "interval_set.h"
+
+#include <thread>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <ranges>
+#include <unordered_set>
+#include <limits>
+#include <cstring>
 
 int main() {
     /*****************************************************
@@ -311,5 +329,1203 @@ int main() {
     }
     assert(Set::get_count_nodes() == 0);
 
+    /*****************************************************
+     * TEST PHASE 10                                      *
+     * Create a Set from unsorted values with repetitions *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 10: create a Set from unsorted values\n";
+
+    {
+        [[maybe_unused]] const Set::Statistics before = Set::get_statistics();
+
+        Set S1 = Set::from_unsorted(std::vector<int>{5, -4, 3, 5, 1, 3, -4});
+        assert(Set::get_count_nodes() == 6);
+        assert(Set::get_statistics().allocations == before.allocations + 1);  // one block for all Nodes
+
+        Set S2 = Set::from_unsorted(std::vector<int>{});
+        assert(S2.is_empty());
+
+        // Test
+        std::ostringstream os{};
+        os << S1 << " " << S2;
+
+        std::string tmp{os.str()};
+        assert((tmp == std::string{"{ -4 1 3 5 } Set is empty!"}));
+
+        // The memory of removed Nodes of the block is reused, and a copy is allocated in one block
+        assert(S1.erase(3) && S1.erase(-4) && S1.insert(7) && S1.insert(2));
+        assert(Set::get_count_nodes() == 8);
+        const Set S3{S1};
+        assert(S3 == S1 && std::ranges::equal(S3, std::vector<int>{1, 2, 5, 7}));
+        assert(Set::get_statistics().allocations == before.allocations + 2);
+        S1.make_empty();
+        assert(S1.insert(3) && S1 == 3 && Set::get_statistics().allocations == before.allocations + 3);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 11                                      *
+     * Node statistics and mixed-sign merges              *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 11: node statistics\n";
+
+    {
+        [[maybe_unused]] const Set::Statistics before = Set::get_statistics();
+
+        Set S1{std::vector<int>{-3}};
+        Set S2{std::vector<int>{-1}};
+        S1 += S2;
+        S1 *= S2;
+
+        [[maybe_unused]] const Set::Statistics after = Set::get_statistics();
+
+        // Test
+        assert(S1 == Set{-1});
+        assert(after.live_nodes == before.live_nodes + 6);
+        assert(after.allocations == before.allocations + 3);  // the dummy Nodes are not allocated
+        assert(after.bytes > before.bytes);
+        assert(after.peak_live_nodes >= after.live_nodes);
+        assert(after.union_steps > before.union_steps);
+        assert(after.intersection_steps > before.intersection_steps);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 12                                      *
+     * ConcurrentSet: insert, erase, is_member and        *
+     * snapshot from several threads                      *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 12: concurrent set\n";
+
+    {
+        ConcurrentSet C{};
+        const int n_threads = 4;
+        const int n = 2000;
+
+        {
+            std::vector<std::jthread> workers;
+            for (int t = 0; t < n_threads; ++t) {
+                workers.emplace_back([&C, t] {
+                    // Thread t inserts all values in [0, n) congruent to t, and removes the odd ones
+                    // The updates are not inside assert, so that they also run with NDEBUG
+                    for (int i = t; i < n; i += n_threads) {
+                        [[maybe_unused]] const bool inserted = C.insert(i);
+                        assert(inserted && C.is_member(i));
+                    }
+                    for (int i = t; i < n; i += n_threads) {
+                        if (i % 2 != 0) {
+                            [[maybe_unused]] const bool erased = C.erase(i);
+                            assert(erased && !C.is_member(i));
+                        }
+                    }
+                });
+            }
+            workers.emplace_back([&C] {
+                for (int i = 0; i < 100; ++i) {
+                    Set S = C.snapshot();
+                    assert(S.cardinality() <= n);
+                }
+            });
+        }
+
+        // Test
+        std::vector<int> evens;
+        for (int i = 0; i < n; i += 2) {
+            evens.push_back(i);
+        }
+        assert(C.snapshot() == Set{evens});
+        assert(C.insert(0) == false);
+        assert(C.erase(1) == false);
+
+        C -= Set{std::vector<int>{0, 2, 4}};
+        C *= Set{std::vector<int>{2, 4, 6, 8}};
+        C += Set{std::vector<int>{-1, 7}};
+        assert(C.snapshot() == Set(std::vector<int>{-1, 6, 7, 8}));
+
+        // Thread t moves a token between -1 - t and n + t, inserting the new value before it removes
+        // the old one: a snapshot taken at a single instant holds at least one of the two values
+        // The values in between make the walk of a snapshot long enough to see the token move
+        ConcurrentSet T{};
+        T += Set{evens};
+        {
+            std::vector<std::jthread> movers;
+            for (int t = 0; t < n_threads; ++t) {
+                T.insert(-1 - t);
+                movers.emplace_back([&T, t] {
+                    for (int i = 0; i < 20000; ++i) {
+                        T.insert((i % 2 == 0) ? n + t : -1 - t);
+                        T.erase((i % 2 == 0) ? -1 - t : n + t);
+                    }
+                });
+            }
+            for (int i = 0; i < 500; ++i) {
+                const Set S = T.snapshot();
+                for (int t = 0; t < n_threads; ++t) {
+                    assert(S.is_member(-1 - t) || S.is_member(n + t));
+                }
+            }
+        }
+        assert(T.is_member(-1) && !T.is_member(n) && T.snapshot().cardinality() == evens.size() + n_threads);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 13                                      *
+     * Iterators: begin, end, lower_bound, find, and      *
+     * std algorithms and ranges                          *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 13: iterators and ranges\n";
+
+    {
+        std::vector<int> A1{-4, 1, 3, 5, 8};
+        Set S1{A1};
+        Set S2{};
+
+        // Test
+        assert(std::ranges::equal(S1, A1));
+        assert(S2.begin() == S2.end());
+        assert(std::ranges::distance(S1) == 5);
+        assert(*std::prev(S1.end()) == 8);
+        assert(std::ranges::equal(S1 | std::views::reverse, A1 | std::views::reverse));
+
+        assert(*S1.lower_bound(2) == 3);
+        assert(*S1.lower_bound(3) == 3);
+        assert(S1.lower_bound(9) == S1.end());
+        assert(S1.find(5) != S1.end() && *S1.find(5) == 5);
+        assert(S1.find(4) == S1.end());
+
+        [[maybe_unused]] auto evens = S1 | std::views::filter([](int v) { return v % 2 == 0; });
+        assert(std::ranges::equal(evens, std::vector<int>{-4, 8}));
+        assert(std::ranges::is_sorted(S1));
+        assert(Set::get_count_nodes() == 9);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 14                                      *
+     * Binary format and memory-mapped Sets               *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 14: binary format and mapped Sets\n";
+
+    {
+        std::vector<int> sparse{-1000000, -7, 0, 3, 4, 5, 6, 100};
+        std::vector<int> dense;
+        for (int i = -100; i < 100; ++i) {
+            if (i % 3 != 0) dense.push_back(i);
+        }
+        std::vector<int> spread{-2000000000, -1000000000, 0, 1000000000, 2000000000};
+
+        const std::filesystem::path file = std::filesystem::temp_directory_path() / "tnd004_lab2_set.bin";
+
+        for (const auto& [values, encoding] :
+             {std::pair{sparse, SetEncoding::varint_delta}, std::pair{dense, SetEncoding::bitmap},
+              std::pair{spread, SetEncoding::int32_array}, std::pair{std::vector<int>{}, SetEncoding::int32_array}}) {
+            const Set S{values};
+            {
+                std::ofstream out{file, std::ios::binary};
+                write_binary(out, S);
+            }
+
+            MappedSet M{file};
+            [[maybe_unused]] const SetView& V = M.view();
+
+            // Test
+            assert(V.encoding() == encoding);
+            assert(V.cardinality() == values.size());
+            assert(std::ranges::equal(V, values));
+            assert(V.to_set() == S);
+            for ([[maybe_unused]] int v : values) {
+                assert(V.is_member(v));
+                assert(V.is_member(v + 1) == S.is_member(v + 1));
+            }
+            assert(V.is_member(-99999) == S.is_member(-99999));
+
+            const Set T{std::vector<int>{-7, 1, 2, 3}};
+            assert((V + T) == (S + T));
+            assert((T + V) == (S + T));
+            assert((V * T) == (S * T));
+            assert((V - T) == (S - T));
+            assert((T - V) == (T - S));
+        }
+
+        std::filesystem::remove(file);
+
+        // Malformed headers are rejected: the header fields are patched in an aligned copy
+        auto header_of = [](const Set& S, SetEncoding encoding) {
+            std::ostringstream os;
+            write_binary(os, S, encoding);
+            const std::string bytes = os.str();
+            std::vector<std::uint64_t> words((bytes.size() + 7) / 8);
+            std::memcpy(words.data(), bytes.data(), bytes.size());
+            return words;  // words[1] = count, words[2] = min and max, words[3] = payload bytes
+        };
+        [[maybe_unused]] auto rejected = [](const std::vector<std::uint64_t>& words) {
+            try {
+                SetView V{std::as_bytes(std::span{words})};
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        };
+
+        std::vector<std::uint64_t> W = header_of(Set{}, SetEncoding::int32_array);
+        assert(!rejected(W));
+        W[1] = std::uint64_t{1} << 62;  // 4 * count overflows to 0
+        assert(rejected(W));
+
+        W = header_of(Set{std::vector<int>{1, 2, 3}}, SetEncoding::bitmap);
+        assert(!rejected(W));
+        W[2] = 0x00000000'00000005;  // min = 5 > max = 0
+        assert(rejected(W));
+        W = header_of(Set{std::vector<int>{1, 2, 3}}, SetEncoding::bitmap);
+        W[1] = 4;  // more values than the 3 ints in [1, 3]
+        assert(rejected(W));
+
+        W = header_of(Set{std::vector<int>{1, 2}}, SetEncoding::int32_array);
+        W[1] = 0;  // an empty Set with a payload
+        assert(rejected(W));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 15                                      *
+     * FrozenSet: compressed immutable Sets               *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 15: compressed immutable Sets\n";
+
+    {
+        std::vector<int> A1;
+        for (int i = 0; i < 100000; ++i) {
+            A1.push_back(-500000 + 10 * i + (i * 7) % 10);
+        }
+        const Set S1{A1};
+        const FrozenSet F1{S1};
+
+        // Test
+        assert(F1.cardinality() == A1.size());
+        assert(std::ranges::equal(F1, A1));
+        assert(F1.to_set() == S1);
+        assert(F1.memory_bytes() * 8 < 6 * A1.size());  // a few bits per value
+
+        for (int v = A1.front() - 20; v < A1.front() + 2000; ++v) {
+            assert(F1.is_member(v) == std::ranges::binary_search(A1, v));
+        }
+        assert(F1.is_member(A1.back()));
+        assert(F1.is_member(A1.back() + 1) == false);
+        assert(F1.is_member(-2000000000) == false);
+        assert(F1.is_member(2000000000) == false);
+
+        const Set S2{std::vector<int>{-499993, -499990, -499989, 0, 7}};
+        const FrozenSet F2{S2};
+        assert((F1 + S2) == (S1 + S2));
+        assert((S2 + F1) == (S1 + S2));
+        assert((F1 * S2) == (S1 * S2));
+        assert((F1 - S2) == (S1 - S2));
+        assert((S2 - F1) == (S2 - S1));
+        assert((F1 * F2) == FrozenSet{S1 * S2});
+        assert((F2 - F1) == FrozenSet{S2 - S1});
+        assert((F1 + F2).cardinality() == (S1 + S2).cardinality());
+
+        const FrozenSet F3{};
+        assert(F3.is_empty() && F3.begin() == F3.end() && !F3.is_member(0));
+        assert((F3 + F2) == F2);
+
+        const FrozenSet F4{std::vector<int>{-2147483647 - 1, 2147483647}};
+        assert(F4.is_member(-2147483647 - 1) && F4.is_member(2147483647) && !F4.is_member(0));
+        assert(std::ranges::equal(F4, std::vector<int>{-2147483647 - 1, 2147483647}));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 16                                      *
+     * Union and intersection of many Sets                *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 16: union_all and intersect_all\n";
+
+    {
+        std::vector<Set> sets;
+        sets.emplace_back(std::vector<int>{1, 3, 5, 8, 12});
+        sets.emplace_back(std::vector<int>{-2, 3, 8, 12, 20});
+        sets.emplace_back(std::vector<int>{3, 8, 9});
+        sets.emplace_back(std::vector<int>{0, 3, 8, 12});
+
+        const Set U = Set::union_all(sets);
+        const Set I = Set::intersect_all(sets);
+
+        // Test
+        assert(U == Set(std::vector<int>{-2, 0, 1, 3, 5, 8, 9, 12, 20}));
+        assert(I == Set(std::vector<int>{3, 8}));
+
+        Set folded_union{};
+        Set folded_intersection{sets[0]};
+        for (const Set& S : sets) {
+            folded_union += S;
+            folded_intersection *= S;
+        }
+        assert(U == folded_union);
+        assert(I == folded_intersection);
+
+        sets.emplace_back();  // an empty Set empties the intersection
+        assert(Set::intersect_all(sets).is_empty());
+        assert(Set::union_all(sets) == U);
+
+        assert(Set::union_all({}).is_empty());
+        assert(Set::intersect_all({}).is_empty());
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 17                                      *
+     * Parallel merge-path union, intersection, and       *
+     * difference of sorted arrays                        *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 17: parallel merge-path set operations\n";
+
+    {
+        std::vector<int> A1, A2;
+        for (int i = 0; i < 200000; ++i) {
+            if (i % 3 != 0) A1.push_back(i);
+            if (i % 5 != 1) A2.push_back(i - 50000);
+        }
+
+        for ([[maybe_unused]] unsigned n_threads : {1u, 2u, 3u, 8u}) {
+            std::vector<int> expected;
+
+            // Test
+            std::ranges::set_union(A1, A2, std::back_inserter(expected));
+            assert(parallel_union(A1, A2, n_threads) == expected);
+
+            expected.clear();
+            std::ranges::set_intersection(A1, A2, std::back_inserter(expected));
+            assert(parallel_intersection(A1, A2, n_threads) == expected);
+
+            expected.clear();
+            std::ranges::set_difference(A2, A1, std::back_inserter(expected));
+            assert(parallel_difference(A2, A1, n_threads) == expected);
+        }
+
+        assert(parallel_union(A1, {}, 4) == A1);
+        assert(parallel_intersection({}, A2, 4).empty());
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 18                                      *
+     * Sizes of intersection, union, and difference, and  *
+     * Jaccard similarity, without creating Sets          *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 18: cardinality-only set operations\n";
+
+    {
+        std::vector<int> A1, A2;
+        for (int i = -300; i < 300; ++i) {
+            if (i % 2 == 0) A1.push_back(i);
+            if (i % 3 == 0) A2.push_back(i + 100);
+        }
+        const Set S1{A1};
+        const Set S2{A2};
+        [[maybe_unused]] const int nodes = Set::get_count_nodes();
+
+        // Test
+        assert(S1.intersection_size(S2) == (S1 * S2).cardinality());
+        assert(S1.union_size(S2) == (S1 + S2).cardinality());
+        assert(S1.difference_size(S2) == (S1 - S2).cardinality());
+        assert(S2.difference_size(S1) == (S2 - S1).cardinality());
+        assert(S1.jaccard(S1) == 1.0);
+        assert(Set{}.jaccard(Set{}) == 1.0);
+        assert(S1.jaccard(Set{1000}) == 0.0);
+        assert(Set::get_count_nodes() == nodes);
+
+        [[maybe_unused]] const double j = S1.jaccard(S2);
+        assert(j == static_cast<double>((S1 * S2).cardinality()) / static_cast<double>((S1 + S2).cardinality()));
+
+        const std::filesystem::path file1 = std::filesystem::temp_directory_path() / "tnd004_lab2_set1.bin";
+        const std::filesystem::path file2 = std::filesystem::temp_directory_path() / "tnd004_lab2_set2.bin";
+        for (SetEncoding e1 : {SetEncoding::bitmap, SetEncoding::int32_array, SetEncoding::varint_delta}) {
+            for (SetEncoding e2 : {SetEncoding::bitmap, SetEncoding::int32_array, SetEncoding::varint_delta}) {
+                {
+                    std::ofstream out1{file1, std::ios::binary};
+                    write_binary(out1, S1, e1);
+                    std::ofstream out2{file2, std::ios::binary};
+                    write_binary(out2, S2, e2);
+                }
+                MappedSet M1{file1};
+                MappedSet M2{file2};
+
+                assert(M1.view().intersection_size(M2.view()) == S1.intersection_size(S2));
+                assert(M2.view().union_size(M1.view()) == S1.union_size(S2));
+                assert(M1.view().difference_size(M2.view()) == S1.difference_size(S2));
+                assert(M1.view().jaccard(M2.view()) == j);
+            }
+        }
+        std::filesystem::remove(file1);
+        std::filesystem::remove(file2);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 19                                      *
+     * is_subset_of and is_superset_of                    *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 19: subset and superset\n";
+
+    {
+        Set S1{std::vector<int>{-5, 1, 3, 5, 8}};
+        Set S2{std::vector<int>{1, 5, 8}};
+        Set S3{std::vector<int>{1, 6, 8}};
+        Set S4{std::vector<int>{-6, 1}};
+        Set S5{};
+
+        // Test
+        assert(S2.is_subset_of(S1));
+        assert(S1.is_superset_of(S2));
+        assert(S1.is_subset_of(S1));
+        assert(S3.is_subset_of(S1) == false);
+        assert(S4.is_subset_of(S1) == false);  // -6 is below the smallest value of S1
+        assert(S1.is_subset_of(S2) == false);
+        assert(S5.is_subset_of(S1) && S5.is_subset_of(S5));
+        assert(S1.is_superset_of(S5));
+
+        assert((S2 <=> S1) == std::partial_ordering::less);
+        assert((S1 <=> S2) == std::partial_ordering::greater);
+        assert((S3 <=> S1) == std::partial_ordering::unordered);
+        assert((S3 <=> S2) == std::partial_ordering::unordered);
+        assert((S5 <=> S5) == std::partial_ordering::equivalent);
+        assert((S5 <=> S4) == std::partial_ordering::less);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 20                                      *
+     * CowSet: copy-on-write Sets                         *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 20: copy-on-write Sets\n";
+
+    {
+        std::vector<int> A1;
+        for (int i = 0; i < 1000; ++i) {
+            A1.push_back(3 * i);
+        }
+        CowSet C1{A1};
+        CowSet C2{C1};  // O(1)
+
+        // Test
+        assert(C2.shares_storage_with(C1));
+        assert(C1 == C2 && C2.cardinality() == 1000);
+        assert(std::ranges::equal(C2, A1));
+
+        assert(C2.insert(4));
+        assert(C2.insert(4) == false);
+        assert(C2.erase(3));
+        assert(C2.erase(3) == false);
+        assert(C2.insert(-1) && C2.insert(5000));
+        assert(!C2.shares_storage_with(C1));
+
+        // C1 is not modified by the changes to its copy
+        assert(std::ranges::equal(C1, A1));
+        assert(C1.is_member(3) && !C1.is_member(4));
+        assert(C2.is_member(4) && !C2.is_member(3) && C2.is_member(-1) && C2.is_member(5000));
+        assert(C2.cardinality() == 1002);
+
+        // Enough insertions in one chunk to split it several times
+        CowSet C3{};
+        for (int i = 0; i < 500; ++i) {
+            assert(C3.insert(1000 - 2 * i));
+        }
+        for (int i = 0; i < 500; i += 2) {
+            assert(C3.erase(1000 - 2 * i));
+        }
+        assert(C3.cardinality() == 250);
+        assert(std::ranges::is_sorted(C3));
+
+        const Set S1{A1};
+        const Set S3 = C3.to_set();
+        assert((C1 + C3).to_set() == S1 + S3);
+        assert((C1 * C3).to_set() == S1 * S3);
+        assert((C1 - C3).to_set() == S1 - S3);
+        assert(CowSet{S3} == C3);
+        assert(CowSet{} == CowSet{Set{}});
+
+        // A modification of a copy copies only the path to one chunk
+        std::vector<int> A4;
+        for (int i = 0; i < 200000; ++i) {
+            A4.push_back(2 * i);
+        }
+        const CowSet C4{A4};
+        CowSet C5{C4};
+        [[maybe_unused]] const size_t nodes = C4.nodes_shared_with(C4);
+        assert(nodes > 200000 / CowSet::chunk_capacity);
+        assert(C5.insert(2001) && C5.erase(4000));
+        assert(C5.nodes_shared_with(C4) + 10 >= nodes);
+        assert(std::ranges::equal(C4, A4) && C5.cardinality() == C4.cardinality());
+
+        // Many modifications: splits of chunks and branches, removal of empty chunks
+        std::vector<bool> in_c5(400000);
+        for (int v : C5) {
+            in_c5[v] = true;
+        }
+        for (int i = 0; i < 200000; ++i) {
+            const int v = (i * 7919) % 400000;
+            if (v % 3 == 0) {
+                assert(C5.erase(v) == in_c5[v]);
+            } else {
+                assert(C5.insert(v) == !in_c5[v]);
+            }
+            in_c5[v] = (v % 3 != 0);
+        }
+        for (int v = 0; v < 400000; v += 2) {
+            C5.erase(v);
+            in_c5[v] = false;
+        }
+        std::vector<int> A5;
+        for (int v = 0; v < 400000; ++v) {
+            if (in_c5[v]) {
+                A5.push_back(v);
+            }
+        }
+        assert(C5.cardinality() == A5.size() && std::ranges::equal(C5, A5) && C5 == CowSet{A5});
+        assert(std::ranges::equal(C4, A4) && C5.insert(0) && C5.is_member(0));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 21                                      *
+     * Bloom filter for is_member                         *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 21: Bloom filter for is_member\n";
+
+    {
+        std::vector<int> A1;
+        for (int i = 0; i < 1000; ++i) {
+            A1.push_back(2 * i);
+        }
+        Set S1{A1};
+        S1.enable_bloom_filter();
+
+        // Test
+        assert(S1.has_bloom_filter() && S1.bloom_filter_bytes() > 0);
+        assert(S1.bloom_filter_false_positive_rate() < 0.05);
+        for (int i = -10; i < 2010; ++i) {
+            assert(S1.is_member(i) == (i >= 0 && i < 2000 && i % 2 == 0));
+        }
+
+        // Insertions update the filter, which grows when it is full
+        S1 += Set{std::vector<int>{-5, 1, 3001}};
+        for (int i = 5000; i < 9000; i += 2) {
+            S1 += Set{i};
+        }
+        assert(S1.is_member(-5) && S1.is_member(1) && S1.is_member(3001) && S1.is_member(8998));
+        assert(S1.bloom_filter_false_positive_rate() < 0.05);
+
+        // Removals rebuild the filter
+        S1 -= Set{std::vector<int>{-5, 0, 2}};
+        S1 *= Set{std::vector<int>{1, 4, 6, 3001}};
+        assert(S1 == Set(std::vector<int>{1, 4, 6, 3001}));
+        assert(!S1.is_member(0) && !S1.is_member(8998) && S1.is_member(3001));
+
+        // Copies keep the filter, with more bits per value the false-positive rate drops
+        Set S2{S1};
+        assert(S2.has_bloom_filter() && S2.is_member(4) && !S2.is_member(5));
+        Set S3{A1};
+        S3.enable_bloom_filter(16.0);
+        assert(S3.bloom_filter_false_positive_rate() < S2.bloom_filter_false_positive_rate() ||
+               S3.bloom_filter_bytes() > S2.bloom_filter_bytes());
+        S2 = S3;
+        assert(S2.is_member(1998) && !S2.is_member(1999));
+
+        S2.make_empty();
+        assert(!S2.is_member(0));
+        S2.disable_bloom_filter();
+        assert(!S2.has_bloom_filter() && S2.bloom_filter_bytes() == 0);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 22                                      *
+     * SmallSet: generic Sets with inline storage         *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 22: generic Sets with inline storage\n";
+
+    {
+        SmallSet<int> S1{};
+        SmallSet<int> S2{5};
+        SmallSet<int, std::less<int>, 4> S3{std::vector<int>{1, 3, 5, 7}};
+
+        // Test
+        assert(S1.is_empty() && S1.is_inline());
+        assert(S2.cardinality() == 1 && S2.is_member(5) && !S2.is_member(4));
+        assert(S3.is_inline() && S3.cardinality() == 4);
+
+        assert(S3.insert(4));  // the fifth value spills to the heap
+        assert(!S3.insert(4));
+        assert(!S3.is_inline() && S3.cardinality() == 5);
+        assert(std::ranges::equal(S3, std::vector<int>{1, 3, 4, 5, 7}));
+        assert(S3.erase(1) && !S3.erase(1));
+        assert(!S3.is_inline());  // stays on the heap until N / 2 values are left
+        assert(S3.insert(1) && S3.erase(1) && !S3.is_inline());
+        assert(std::ranges::equal(S3, std::vector<int>{3, 4, 5, 7}));
+        assert(S3.erase(7) && S3.erase(5) && S3.is_inline());  // back to the inline buffer
+        assert(S3.insert(5) && S3.insert(7) && S3.is_inline());
+        assert(std::ranges::equal(S3, std::vector<int>{3, 4, 5, 7}));
+
+        // A moved-from Set is empty and inline, and can be used again
+        SmallSet<int, std::less<int>, 4> S6{std::vector<int>{1, 2, 3, 4, 5, 6}};
+        SmallSet<int, std::less<int>, 4> S7{std::move(S6)};
+        assert(S6.is_empty() && S6.is_inline() && S6.begin() == S6.end());
+        assert(S6.insert(9) && S6.is_member(9) && S6.cardinality() == 1);
+        S6 = std::move(S7);
+        assert(S7.is_empty() && S7.is_inline() && !S7.is_member(1));
+        assert(!S6.is_inline() && std::ranges::equal(S6, std::vector<int>{1, 2, 3, 4, 5, 6}));
+        assert(S7.insert(2) && S7.insert(1) && std::ranges::equal(S7, std::vector<int>{1, 2}));
+
+        SmallSet<int, std::less<int>, 4> S4{std::vector<int>{4, 6, 7, 8, 9}};
+        assert(std::ranges::equal(S3 + S4, std::vector<int>{3, 4, 5, 6, 7, 8, 9}));
+        assert(std::ranges::equal(S3 * S4, std::vector<int>{4, 7}));
+        assert(std::ranges::equal(S4 - S3, std::vector<int>{6, 8, 9}));
+        assert((S3 * S4).is_inline());
+        assert(((S3 * S4) <=> S3) == std::partial_ordering::less);
+        assert((S3 <=> S4) == std::partial_ordering::unordered);
+        assert((S3 <=> S3) == std::partial_ordering::equivalent);
+
+        // Other key types and comparators
+        SmallSet<std::string, std::greater<std::string>, 2> S5{std::vector<std::string>{"c", "b", "a"}};
+        assert(!S5.is_inline() && S5.is_member("b") && !S5.is_member("d"));
+        assert(*S5.begin() == "c");
+        S5 -= SmallSet<std::string, std::greater<std::string>, 2>{"b"};
+        assert(!S5.is_inline() && S5.cardinality() == 2 && *S5.begin() == "c");
+        S5 *= SmallSet<std::string, std::greater<std::string>, 2>{"a"};
+        assert(S5.is_inline() && S5.cardinality() == 1 && *S5.begin() == "a");
+
+        std::ostringstream os;
+        os << S3 << " " << S1;
+        assert(os.str() == "{ 3 4 5 7 } Set is empty!");
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 23                                      *
+     * insert and erase                                   *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 23: insert and erase\n";
+
+    {
+        Set S1{};
+
+        // Test
+        assert(S1.insert(5) && S1.insert(1) && S1.insert(3));
+        assert(S1.insert(3) == false);
+        assert(S1 == Set(std::vector<int>{1, 3, 5}));
+        assert(Set::get_count_nodes() == 5);  // no temporary Sets
+
+        assert(S1.erase(3) && S1.erase(3) == false && S1.erase(4) == false);
+        assert(S1 == Set(std::vector<int>{1, 5}));
+
+        // Sorted appends with the hint end(): O(1) each
+        Set S2{};
+        for (int i = 0; i < 1000; ++i) {
+            S2.insert(S2.end(), 2 * i);
+        }
+        assert(S2.cardinality() == 1000);
+        assert(std::ranges::is_sorted(S2));
+
+        // Wrong hints are corrected, in both directions
+        Set::const_iterator it = S2.insert(S2.begin(), 1001);
+        assert(*it == 1001 && *std::prev(it) == 1000 && *std::next(it) == 1002);
+        it = S2.insert(S2.end(), -1);
+        assert(it == S2.begin() && *it == -1);
+        it = S2.insert(S2.find(10), 10);  // already a member
+        assert(*it == 10 && S2.cardinality() == 1002);
+
+        // Erase all odd values while iterating
+        for (Set::const_iterator pos = S2.begin(); pos != S2.end();) {
+            pos = (*pos % 2 != 0) ? S2.erase(pos) : std::next(pos);
+        }
+        assert(S2.cardinality() == 1000 && !S2.is_member(1001) && !S2.is_member(-1));
+        assert(Set::get_count_nodes() == 2 + 4 + 1000);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 24                                      *
+     * UnrolledSet: unrolled linked lists                 *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 24: unrolled linked lists\n";
+
+    {
+        std::vector<int> A1;
+        for (int i = 0; i < 1000; ++i) {
+            A1.push_back(3 * i);
+        }
+        UnrolledSet U1{A1};
+        UnrolledSet U2{U1};
+
+        // Test
+        assert(U1.cardinality() == 1000 && U1 == U2);
+        assert(U1.block_count() == (1000 + UnrolledSet::block_capacity - 1) / UnrolledSet::block_capacity);
+        assert(std::ranges::equal(U1, A1));
+        assert(U1.is_member(0) && U1.is_member(2997) && !U1.is_member(1) && !U1.is_member(3000));
+
+        // Inserts in the middle split full Blocks
+        for (int i = 0; i < 1000; ++i) {
+            assert(U2.insert(3 * i + 1));
+        }
+        assert(!U2.insert(1) && U2.insert(-1) && U2.insert(5000));
+        assert(U2.cardinality() == 2002);
+        assert(std::ranges::is_sorted(U2));
+
+        // Erases merge almost empty Blocks
+        [[maybe_unused]] const size_t blocks = U2.block_count();
+        for (int i = 0; i < 1000; ++i) {
+            assert(U2.erase(3 * i + 1));
+        }
+        assert(!U2.erase(1) && U2.erase(-1) && U2.erase(5000));
+        assert(U2 == U1);
+        assert(U2.block_count() <= blocks);
+
+        UnrolledSet U5{U1};
+        for (int i = 0; i < 1000; ++i) {
+            if (i % 32 != 0) {
+                U5.erase(3 * i);
+            }
+        }
+        assert(U5.cardinality() == 32 && U5.block_count() < U1.block_count() / 4);
+
+        // Set operations
+        std::vector<int> A2;
+        for (int i = 0; i < 1000; ++i) {
+            A2.push_back(2 * i - 500);
+        }
+        const UnrolledSet U3{A2};
+        const Set S1{A1};
+        const Set S3{A2};
+        assert((U1 + U3).to_set() == S1 + S3);
+        assert((U1 * U3).to_set() == S1 * S3);
+        assert((U1 - U3).to_set() == S1 - S3);
+        assert((U3 - U1).to_set() == S3 - S1);
+        assert(UnrolledSet{S1} == U1);
+        assert((U1 - U1).is_empty() && (U1 - U1).block_count() == 0);
+
+        UnrolledSet U4{};
+        for (int i = 0; i < 100; ++i) {
+            U4.insert(i % 2 == 0 ? i : -i);
+        }
+        U4 *= U3;  // keep the even values 0, 2, ..., 98
+        assert(U4.cardinality() == 50 && U4.is_member(98) && !U4.is_member(-1));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 25                                      *
+     * Allocation-free empty Sets and moves               *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 25: allocation-free empty Sets and moves\n";
+
+    {
+        [[maybe_unused]] const Set::Statistics before = Set::get_statistics();
+
+        Set S1{};
+        Set S2{std::vector<int>{1, 2, 3}};
+        Set S3{std::move(S2)};  // O(1)
+
+        // Test
+        assert(S1.is_empty() && S2.is_empty());
+        assert(S3 == Set(std::vector<int>{1, 2, 3}));
+        assert(Set::get_statistics().allocations == before.allocations + 1 + 1);  // one block per Set
+
+        [[maybe_unused]] const Set::Statistics moved = Set::get_statistics();
+        S1 = std::move(S3);
+        S3 = Set{};
+        S1.swap(S3);
+        S1.swap(S2);  // two empty Sets
+        S3.make_empty();
+        assert(S1.is_empty() && S2.is_empty() && S3.is_empty());
+        assert(Set::get_statistics().allocations == moved.allocations);
+        assert(Set::get_count_nodes() == 6);  // the dummy Nodes are still counted
+
+        // Moved Sets are linked to their own dummy Nodes
+        S1.insert(5);
+        S2 = S1;
+        S1.insert(4);
+        Set S4{std::move(S1)};
+        S4.insert(6);
+        assert(std::ranges::equal(S4, std::vector<int>{4, 5, 6}));
+        assert(std::ranges::equal(S4 | std::views::reverse, std::vector<int>{6, 5, 4}));
+        assert(S1.is_empty() && S1.insert(1) && S1 == Set{1});
+        assert(S2 == Set{5});
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 26                                      *
+     * Operators with an int operand                      *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 26: operators with an int operand\n";
+
+    {
+        Set S1{std::vector<int>{1, 3, 5}};
+        Set S2{7};
+        const Set S3{};
+
+        [[maybe_unused]] const Set::Statistics before = Set::get_statistics();
+
+        // Test: comparisons create no Set
+        assert(S2 == 7 && 7 == S2 && S2 != 8 && S1 != 1);
+        assert(3 < S1 && S1 > 3 && !(4 < S1) && !(S1 < 3));
+        assert((S2 <=> 7) == std::partial_ordering::equivalent);
+        assert((S2 <=> 8) == std::partial_ordering::unordered);
+        assert((S3 <=> 8) == std::partial_ordering::less && S3 < 8 && 8 > S3);
+        assert(Set::get_statistics().allocations == before.allocations);
+
+        S1 += 4;
+        S1 += 4;
+        S1 -= 1;
+        S1 -= 2;
+        assert(Set::get_statistics().allocations == before.allocations + 1);  // the Node of 4
+        assert(S1 == Set(std::vector<int>{3, 4, 5}));
+
+        assert(S1 + 9 == Set(std::vector<int>{3, 4, 5, 9}));
+        assert(9 + S1 == S1 + 9);
+        assert(S1 * 4 == 4 && 4 * S1 == 4 && (S1 * 6).is_empty());
+        assert(S1 - 4 == Set(std::vector<int>{3, 5}));
+        assert(4 - S1 == Set{} && 6 - S1 == 6);
+
+        S1 *= 5;
+        assert(S1 == 5 && S1.cardinality() == 1);
+        S1 *= 6;
+        assert(S1.is_empty());
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 27                                      *
+     * Fingerprints and hashing                           *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 27: fingerprints and hashing\n";
+
+    {
+        Set S1{std::vector<int>{1, 3, 5}};
+        Set S2{};
+        S2.insert(5);
+        S2.insert(3);
+        S2.insert(1);
+        Set S3{std::vector<int>{1, 3, 6}};
+
+        // Test: the fingerprint does not depend on how a Set was built
+        assert(S1.hash() == S2.hash() && S1 == S2);
+        assert(S1.hash() != S3.hash() && S1 != S3);
+        assert(Set{}.hash() == 0);
+
+        S3 -= 6;
+        S3 += 5;
+        assert(S3.hash() == S1.hash() && S3 == S1);
+        S3 *= Set{std::vector<int>{1, 5}};
+        assert(S3.hash() == Set(std::vector<int>{1, 5}).hash());
+        S3.make_empty();
+        assert(S3.hash() == 0);
+
+        Set S4 = Set::from_unsorted({5, 1, 3, 3});
+        assert(S4.hash() == S1.hash());
+        Set S5{std::move(S4)};
+        assert(S5.hash() == S1.hash() && S4.hash() == 0);
+
+        std::unordered_set<Set> sets{S1, S2, S3, Set{7}, Set{7}};
+        assert(sets.size() == 3);
+        assert(sets.contains(Set(std::vector<int>{1, 3, 5})) && sets.contains(Set{}) && !sets.contains(Set{8}));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 28                                      *
+     * PoolSet: index-linked Nodes in one pool            *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 28: index-linked Nodes in one pool\n";
+
+    {
+        std::vector<int> A1;
+        for (int i = 0; i < 1000; ++i) {
+            A1.push_back(3 * i);
+        }
+        PoolSet P1{A1};
+        PoolSet P2{P1};  // the pool is copied in one block
+
+        // Test
+        assert(P1.cardinality() == 1000 && P1 == P2);
+        assert(std::ranges::equal(P1, A1));
+        assert(std::ranges::equal(P1 | std::views::reverse, A1 | std::views::reverse));
+        assert(P1.is_member(0) && P1.is_member(2997) && !P1.is_member(1));
+        assert(P1.memory_bytes() < 1000 * (sizeof(int) + 2 * sizeof(void*)));
+
+        // Free Slots are reused
+        assert(P2.erase(3) && !P2.erase(3) && P2.insert(4) && !P2.insert(4));
+        [[maybe_unused]] const size_t bytes = P2.memory_bytes();
+        for (int i = 0; i < 100; ++i) {
+            assert(P2.erase(6 * i));
+        }
+        for (int i = 0; i < 100; ++i) {
+            assert(P2.insert(6 * i + 1));
+        }
+        assert(P2.memory_bytes() == bytes && P2.cardinality() == 1000);
+        assert(std::ranges::is_sorted(P2));
+        assert(P1.is_member(3) && !P1.is_member(4));  // P1 is not modified
+
+        PoolSet P3{P2};
+        P3.compact();
+        assert(P3 == P2);
+
+        // A moved-from PoolSet is empty and can be used again
+        static_assert(std::is_nothrow_move_constructible_v<PoolSet> && std::is_nothrow_move_assignable_v<PoolSet>);
+        const PoolSet P0{};
+        assert(P0.memory_bytes() == sizeof(PoolSet) && P0.begin() == P0.end() && !P0.is_member(0));
+        PoolSet P5{std::move(P3)};
+        assert(P5 == P2 && P3.is_empty() && P3.begin() == P3.end() && !P3.is_member(4));
+        assert(P3.insert(4) && P3.insert(2) && std::ranges::equal(P3, std::vector<int>{2, 4}));
+        P3 = std::move(P5);
+        assert(P3 == P2 && P5.is_empty() && P5.memory_bytes() == sizeof(PoolSet));
+        assert(P5.insert(7) && P5.cardinality() == 1 && (P5 + P3) == (P3 + P5));
+
+        std::vector<int> A2;
+        for (int i = 0; i < 1000; ++i) {
+            A2.push_back(2 * i - 500);
+        }
+        const PoolSet P4{A2};
+        const Set S1{A1};
+        const Set S4{A2};
+        assert((P1 + P4).to_set() == S1 + S4);
+        assert((P1 * P4).to_set() == S1 * S4);
+        assert((P1 - P4).to_set() == S1 - S4);
+        assert((P4 - P1).to_set() == S4 - S1);
+        assert(PoolSet{S1} == P1 && PoolSet{} == PoolSet{Set{}});
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 29                                      *
+     * rank, select and count_range                       *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 29: rank, select and count_range\n";
+
+    {
+        std::vector<int> A1;
+        for (int i = 0; i < 1000; ++i) {
+            A1.push_back(10 * i - 5000);
+        }
+        Set S1{A1};
+        const Set S0{A1};  // without index: the queries walk the list
+        S1.enable_order_index();
+
+        // Test
+        assert(S1.has_order_index() && !S0.has_order_index());
+        for ([[maybe_unused]] const Set* S : std::initializer_list<const Set*>{&S0, &S1}) {
+            assert(S->rank(-5000) == 0 && S->rank(-4999) == 1 && S->rank(0) == 500 && S->rank(100000) == 1000);
+            assert(*S->select(0) == -5000 && *S->select(500) == 0 && *S->select(999) == 4990);
+            assert(S->select(1000) == S->end());
+            assert(S->count_range(0, 99) == 10 && S->count_range(-10, 10) == 3 && S->count_range(5, 1) == 0);
+            assert(S->count_range(-100000, 100000) == 1000 && S->count_range(4990, std::numeric_limits<int>::max()) == 1);
+            assert(*S->lower_bound(1) == 10 && S->lower_bound(4991) == S->end());
+            assert(S->find(10) != S->end() && S->find(11) == S->end());
+        }
+
+        // Insertions and removals anywhere update the index
+        S1.insert(S1.end(), 5000);
+        S1 += 6000;
+        assert(S1.rank(6000) == 1001 && *S1.select(1001) == 6000);
+        S1.erase(6000);
+        assert(S1.rank(6000) == 1001 && S1.select(1001) == S1.end() && *S1.select(1000) == 5000);
+        S1.erase(-5000);
+        S1.insert(-4995);
+        S1.insert(5);
+        assert(S1.rank(-4990) == 1 && *S1.select(0) == -4995 && S1.count_range(-5000, -4980) == 3);
+        assert(S1.rank(10) == 502 && *S1.select(501) == 5 && *S1.lower_bound(1) == 5);
+
+        // Merges rebuild the index, copies and moves keep it
+        S1 -= Set{std::vector<int>{-4995, 0, 5}};
+        assert(S1.rank(10) == 499 && S1.count_range(-10, 10) == 2);
+        [[maybe_unused]] const Set S3{S1};
+        assert(S3.has_order_index() && S3.rank(10) == 499 && *S3.select(499) == 10);
+        S1 *= S0;
+        S1 += Set{std::vector<int>{-6000, 7000}};
+        assert(S1.rank(-4990) == 1 && S1.count_range(4980, 7000) == 3 && *S1.select(S1.cardinality() - 1) == 7000);
+
+        Set S2{std::move(S1)};
+        assert(S2.has_order_index() && *S2.select(0) == -6000 && S2.count_range(4990, 7000) == 2);
+        assert(!S1.has_order_index());
+        S2.make_empty();
+        assert(S2.has_order_index() && S2.rank(0) == 0 && S2.select(0) == S2.end() && S2.insert(3) && *S2.select(0) == 3);
+
+        // Random insertions and removals, checked against the list
+        std::vector<int> A2;
+        for (int i = 0; i < 2000; ++i) {
+            A2.push_back((i * 7919) % 2000);
+        }
+        for (int v : A2) {
+            S2.insert(v);
+            if (v % 3 == 0) {
+                S2.erase((v * 31) % 2000);
+            }
+        }
+        size_t k = 0;
+        for ([[maybe_unused]] int v : S2) {
+            assert(S2.rank(v) == k && *S2.select(k) == v);
+            ++k;
+        }
+        assert(S1.rank(0) == 0 && S1.select(0) == S1.end() && S1.count_range(0, 1) == 0);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 30                                      *
+     * IntervalSet: runs of consecutive values            *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 30: runs of consecutive values\n";
+
+    {
+        using Runs [[maybe_unused]] = std::vector<IntervalSet::Interval>;
+
+        IntervalSet I1{1, 1000000};
+        I1.insert(2000000, 3000000);
+        IntervalSet I2{500000, 2500000};
+
+        // Test
+        assert(I1.cardinality() == 2000001 && I1.intervals().size() == 2);
+        assert(I1.is_member(1) && I1.is_member(1000000) && !I1.is_member(1000001) && I1.is_member(3000000));
+
+        assert(std::ranges::equal((I1 + I2).intervals(), Runs{{1, 3000000}}));
+        assert(std::ranges::equal((I1 * I2).intervals(), Runs{{500000, 1000000}, {2000000, 2500000}}));
+        assert(std::ranges::equal((I1 - I2).intervals(), Runs{{1, 499999}, {2500001, 3000000}}));
+        assert(std::ranges::equal((I2 - I1).intervals(), Runs{{1000001, 1999999}}));
+        assert(((I1 * I2) <=> I1) == std::partial_ordering::less);
+        assert((I1 <=> (I1 + I2)) == std::partial_ordering::less);
+        assert((I1 <=> I2) == std::partial_ordering::unordered);
+        assert((I1 <=> I1) == std::partial_ordering::equivalent);
+        assert(((I1 + I2) <=> I2) == std::partial_ordering::greater);
+
+        // Insertions merge runs that touch, erasures split runs
+        IntervalSet I3{};
+        assert(I3.insert(5) && I3.insert(7) && I3.insert(6) && !I3.insert(6));
+        assert(std::ranges::equal(I3.intervals(), Runs{{5, 7}}));
+        assert(I3.erase(6) && !I3.erase(6));
+        assert(std::ranges::equal(I3.intervals(), Runs{{5, 5}, {7, 7}}));
+        assert(I3.erase(5) && I3.erase(7) && I3.is_empty());
+
+        IntervalSet I4{std::numeric_limits<int>::min(), -1};
+        I4.insert(0, std::numeric_limits<int>::max());
+        assert(I4.intervals().size() == 1 && I4.cardinality() == (size_t{1} << 32));
+        assert((I4 - I4).is_empty());
+
+        // Conversions from and to Sets
+        const Set S1{std::vector<int>{1, 2, 3, 4, 5, 10, 11, 12, 13}};
+        const Set S2{std::vector<int>{1, 3, 5, 7, 9}};
+        assert(IntervalSet::compress(S1).has_value() && !IntervalSet::compress(S2).has_value());
+        assert(IntervalSet::compress(Set{}).has_value());
+        const IntervalSet I5{S1};
+        assert(std::ranges::equal(I5.intervals(), Runs{{1, 5}, {10, 13}}));
+        assert(I5.to_set() == S1 && IntervalSet{S2}.to_set() == S2);
+        assert(std::ranges::equal(I5, S1));
+        assert(!I5.is_fragmented() && IntervalSet{S2}.is_fragmented());
+        assert((I5 * IntervalSet{S2}).to_set() == S1 * S2);
+
+        std::ostringstream os;
+        os << I5 << " " << IntervalSet{};
+        assert(os.str() == "{ [1, 5] [10, 13] } Set is empty!");
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 31                                      *
+     * Bulk output of large Sets                          *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 31: bulk output of large Sets\n";
+
+    {
+        std::vector<int> A1;
+        std::ostringstream expected;
+        expected << "{ ";
+        for (int i = 0; i < 100000; ++i) {
+            A1.push_back(37 * i - 1850000);
+            expected << A1.back() << " ";
+        }
+        expected << "}";
+        Set S1{A1};
+        S1.insert(std::numeric_limits<int>::min());
+        S1.insert(std::numeric_limits<int>::max());
+
+        std::ostringstream os1;
+        os1 << Set{A1};
+
+        // Test
+        assert(os1.str() == expected.str());  // written in several chunks
+
+        std::ostringstream os2;
+        os2 << S1 << '|' << Set{} << '|' << Set{7};
+        assert(os2.str().starts_with("{ -2147483648 -1850000 -1849963 "));
+        assert(os2.str().ends_with(" 1849963 2147483647 }|Set is empty!|{ 7 }"));
+
+        // Non-default formatting is still applied to the values
+        std::ostringstream os3;
+        os3 << std::hex << Set{std::vector<int>{10, 255}} << std::dec << std::showpos << " " << Set{3};
+        assert(os3.str() == "{ a ff } { +3 }");
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 32                                      *
+     * operator+=, operator*= and operator-= with         *
+     * negative values                                    *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 32: merges of negative values\n";
+
+    {
+        // One list is exhausted after a comparison with the dummy tail Node of the other
+        Set S1{-3};
+        S1 += Set{-1};
+        assert(S1 == Set(std::vector<int>{-3, -1}));
+
+        Set S2{-1};
+        S2 += Set{-3};
+        assert(S2 == Set(std::vector<int>{-3, -1}));
+
+        Set S3{std::vector<int>{-5, -3}};
+        S3 *= Set{std::vector<int>{-4, -1}};
+        assert(S3.is_empty());
+
+        Set S4{std::vector<int>{-5, -3, -1}};
+        S4 *= Set{std::vector<int>{-3, 0}};
+        assert(S4 == Set{-3});
+
+        Set S5{-3};
+        S5 -= Set{-1};
+        assert(S5 == Set{-3});
+
+        Set S6{std::vector<int>{-7, -2, 4}};
+        S6 -= Set{std::vector<int>{-8, -2, -1}};
+        assert(S6 == Set(std::vector<int>{-7, 4}));
+
+        assert(Set{-3} + Set{-1} + Set{0} == Set(std::vector<int>{-3, -1, 0}));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
     std::cout << "Success!!\n";
 }
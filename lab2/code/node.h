@@ -1,15 +1,20 @@
 #pragma once
 
 #include <cassert>
+#include <new>
 
-/** Class Set::Node
+#include "counters.h"
+
+class Set;
+
+/** Class SetNode
  *
  * This class represents an internal node of a doubly linked list storing an int
- * All members of class Set::Node are public
- * but only class Set can access them, since Node is declared in the private part of class Set
+ * The data members of class SetNode are private, only class Set can access them (as Set::Node)
+ * SetNode is defined before class Set, so that Set can embed its dummy Nodes
  *
  */
-class Set::Node {
+class SetNode {
 public:
     /*
      * Constructor
@@ -17,33 +22,71 @@ public:
      * \param nextPtr a pointer to the next Node in the list
      * \param prevPtr a pointer to the previous Node in the list
      */
-    explicit Node(int nodeVal = 0, Node* nextPtr = nullptr, Node* prevPtr = nullptr)
+    explicit SetNode(int nodeVal = 0, SetNode* nextPtr = nullptr, SetNode* prevPtr = nullptr)
         : value{nodeVal}, next{nextPtr}, prev{prevPtr} {
-        ++count_nodes;
+        NodeCounters::node_created();
     }
 
     /*
      * Destructor
      */
-    ~Node() {
-        --count_nodes;
-        assert(count_nodes >= 0);  // number of existing nodes can never be negative
+    ~SetNode() {
+        NodeCounters::node_destroyed();
+    }
+
+    /*
+     * Allocation and deallocation functions -- count the heap allocations of Nodes
+     */
+    static void* operator new(std::size_t size) {
+        NodeCounters::node_allocated(size);
+        return ::operator new(size);
+    }
+
+    static void operator delete(void* ptr) noexcept {
+        ::operator delete(ptr);
+    }
+
+    /*
+     * Allocate uninitialized memory for n Nodes in one block, counted as a single heap allocation
+     * The Nodes are constructed in the block with placement new, and marked as in_block
+     */
+    static SetNode* allocate_block(std::size_t n) {
+        NodeCounters::node_allocated(n * sizeof(SetNode));
+        return static_cast<SetNode*>(::operator new(n * sizeof(SetNode)));
+    }
+
+    /*
+     * Construct a Node in the block memory at where
+     */
+    static SetNode* create_in_block(SetNode* where, int nodeVal, SetNode* nextPtr, SetNode* prevPtr) {
+        SetNode* p = ::new (static_cast<void*>(where)) SetNode(nodeVal, nextPtr, prevPtr);
+        p->in_block = true;
+        return p;
+    }
+
+    /*
+     * Release a block from allocate_block, after all its Nodes were destroyed
+     */
+    static void deallocate_block(SetNode* block) noexcept {
+        ::operator delete(block);
     }
 
     /*
      * Copy constructor -- disallowed to avoid shallow copying
      */
-    Node(const Node& rhs) = delete;
+    SetNode(const SetNode& rhs) = delete;
 
     /*
      * Assignment operator -- disallowed to avoid shallow copying
      */
-    Node& operator=(const Node& rhs) = delete;
+    SetNode& operator=(const SetNode& rhs) = delete;
 
-    // Data members
-    int value;   // int stored in the Node
-    Node* next;  // Pointer to the next Node
-    Node* prev;  // Pointer to the previous Node
+private:
+    friend class Set;
 
-    static int count_nodes;  // total number of existing nodes -- to help to detect bugs in the code
+    // Data members
+    int value;              // int stored in the Node
+    bool in_block{false};   // whether the Node lives in a block from allocate_block (no delete)
+    SetNode* next;          // Pointer to the next Node
+    SetNode* prev;          // Pointer to the previous Node
 };
@@ -0,0 +1,204 @@
+#include "order_index.h"
+
+#include <cassert>
+
+/*****************************************************
+ * Queries                                            *
+ ******************************************************/
+
+/*
+ * Return the number of values smaller than value: one path from the root
+ */
+size_t OrderIndex::rank(int value) const {
+    size_t r = 0;
+    std::uint32_t t = root;
+    while (t != none) {
+        if (items[t].value < value) {
+            r += size_of(items[t].left) + 1;
+            t = items[t].right;
+        } else {
+            t = items[t].left;
+        }
+    }
+    return r;
+}
+
+/*
+ * Return the Node of the k-th smallest value, or nullptr if k >= size()
+ */
+const SetNode* OrderIndex::select(size_t k) const {
+    std::uint32_t t = root;
+    while (t != none) {
+        const size_t left = size_of(items[t].left);
+        if (k < left) {
+            t = items[t].left;
+        } else if (k == left) {
+            return items[t].node;
+        } else {
+            k -= left + 1;
+            t = items[t].right;
+        }
+    }
+    return nullptr;
+}
+
+/*
+ * Return the Node of the smallest value not less than value, or nullptr if none
+ */
+const SetNode* OrderIndex::lower_bound(int value) const {
+    const SetNode* found = nullptr;
+    std::uint32_t t = root;
+    while (t != none) {
+        if (items[t].value < value) {
+            t = items[t].right;
+        } else {
+            found = items[t].node;
+            t = items[t].left;
+        }
+    }
+    return found;
+}
+
+/*****************************************************
+ * Modifications                                      *
+ ******************************************************/
+
+/*
+ * Add the Node storing value: split the treap at value, and join the three parts
+ */
+void OrderIndex::insert(int value, const SetNode* node) {
+    const auto [smaller, larger] = split(root, value);
+    root = merge(merge(smaller, new_item(value, node)), larger);
+}
+
+/*
+ * Remove value: split the treap at value, value is then the smallest value of the larger part
+ */
+void OrderIndex::erase(int value) {
+    const auto [smaller, larger] = split(root, value);
+    assert(larger != none);
+    root = merge(smaller, remove_min(larger));
+}
+
+/*
+ * Remove all values, the memory of the items is kept
+ */
+void OrderIndex::reset() {
+    items.clear();
+    root = none;
+    free_list = none;
+}
+
+/*
+ * Append an unlinked item for value, larger than all values added before
+ */
+void OrderIndex::add(int value, const SetNode* node) {
+    assert(free_list == none && (items.empty() || items.back().value < value));
+    new_item(value, node);
+}
+
+/*
+ * Link the items added since reset() into a treap: O(n)
+ * The items are in increasing order of values, so the treap is built as a Cartesian tree
+ * with a stack of its right spine; an item gets its size when it leaves the spine
+ */
+void OrderIndex::link() {
+    std::vector<std::uint32_t> spine;
+    for (std::uint32_t i = 0; i < items.size(); ++i) {
+        std::uint32_t last = none;
+        while (!spine.empty() && items[spine.back()].priority < items[i].priority) {
+            last = spine.back();
+            spine.pop_back();
+            update(last);
+        }
+        items[i].left = last;
+        if (!spine.empty()) {
+            items[spine.back()].right = i;
+        }
+        spine.push_back(i);
+    }
+
+    root = spine.empty() ? none : spine.front();
+    while (!spine.empty()) {
+        update(spine.back());
+        spine.pop_back();
+    }
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Create an item for value, with a priority from a splitmix64 generator
+ */
+std::uint32_t OrderIndex::new_item(int value, const SetNode* node) {
+    std::uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    const Item item{node, value, static_cast<std::uint32_t>(z ^ (z >> 31)), 1, none, none};
+
+    std::uint32_t t = free_list;
+    if (t != none) {
+        free_list = items[t].left;
+        items[t] = item;
+    } else {
+        t = static_cast<std::uint32_t>(items.size());
+        items.push_back(item);
+    }
+    return t;
+}
+
+/*
+ * Split treap t into the treaps of the values < value and >= value
+ */
+std::pair<std::uint32_t, std::uint32_t> OrderIndex::split(std::uint32_t t, int value) {
+    if (t == none) {
+        return {none, none};
+    }
+    if (items[t].value < value) {
+        const auto [smaller, larger] = split(items[t].right, value);
+        items[t].right = smaller;
+        update(t);
+        return {t, larger};
+    }
+    const auto [smaller, larger] = split(items[t].left, value);
+    items[t].left = larger;
+    update(t);
+    return {smaller, t};
+}
+
+/*
+ * Join treaps a and b: the root with the highest priority stays on top
+ */
+std::uint32_t OrderIndex::merge(std::uint32_t a, std::uint32_t b) {
+    if (a == none) {
+        return b;
+    }
+    if (b == none) {
+        return a;
+    }
+    if (items[a].priority > items[b].priority) {
+        items[a].right = merge(items[a].right, b);
+        update(a);
+        return a;
+    }
+    items[b].left = merge(a, items[b].left);
+    update(b);
+    return b;
+}
+
+/*
+ * Remove the smallest value of treap t and add its item to the free list
+ */
+std::uint32_t OrderIndex::remove_min(std::uint32_t t) {
+    if (items[t].left == none) {
+        const std::uint32_t right = items[t].right;
+        items[t].left = free_list;
+        free_list = t;
+        return right;
+    }
+    items[t].left = remove_min(items[t].left);
+    update(t);
+    return t;
+}
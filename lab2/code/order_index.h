@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class SetNode;  // defined in node.h
+
+/** Class OrderIndex
+ *
+ * Order-statistic index of the Nodes of a Set: a treap (binary search tree on the values,
+ * heap on random priorities) whose items store the size of their subtree
+ * Hence the rank of a value and the k-th smallest value are found in O(log n) expected time,
+ * and a value is inserted or erased in O(log n) expected time
+ * The items live in one vector and are linked with 32-bit indices, the items of erased values
+ * are reused by later insertions
+ *
+ * The queries only read the index, so they can run concurrently with each other
+ */
+class OrderIndex {
+public:
+    size_t size() const {
+        return size_of(root);
+    }
+
+    /*
+     * Add the Node storing value, which must not belong to the index
+     */
+    void insert(int value, const SetNode* node);
+
+    /*
+     * Remove value, which must belong to the index
+     */
+    void erase(int value);
+
+    /*
+     * Return the number of values smaller than value
+     */
+    size_t rank(int value) const;
+
+    /*
+     * Return the Node of the k-th smallest value (k = 0 for the smallest), or nullptr if k >= size()
+     */
+    const SetNode* select(size_t k) const;
+
+    /*
+     * Return the Node of the smallest value not less than value, or nullptr if none
+     */
+    const SetNode* lower_bound(int value) const;
+
+    /*
+     * Rebuild the index in O(n): reset(), then add() each value in increasing order, then link()
+     * The index must not be used between reset() and link()
+     */
+    void reset();
+    void add(int value, const SetNode* node);
+    void link();
+
+    /*
+     * Return the number of bytes used by the items of the index
+     */
+    size_t memory_bytes() const {
+        return items.capacity() * sizeof(Item);
+    }
+
+private:
+    static constexpr std::uint32_t none = UINT32_MAX;
+
+    struct Item {
+        const SetNode* node;
+        int value;
+        std::uint32_t priority;
+        std::uint32_t size;   // number of items in the subtree of this item
+        std::uint32_t left;   // left child, or next free item
+        std::uint32_t right;  // right child
+    };
+
+    std::vector<Item> items;
+    std::uint32_t root{none};
+    std::uint32_t free_list{none};  // first free item, linked through left
+    std::uint64_t seed{0};          // state of the generator of priorities
+
+    size_t size_of(std::uint32_t t) const {
+        return (t == none) ? 0 : items[t].size;
+    }
+
+    /*
+     * Recompute the size of item t from its children
+     */
+    void update(std::uint32_t t) {
+        items[t].size = static_cast<std::uint32_t>(1 + size_of(items[t].left) + size_of(items[t].right));
+    }
+
+    /*
+     * Create an item for value, with a random priority, reusing a free item if any
+     */
+    std::uint32_t new_item(int value, const SetNode* node);
+
+    /*
+     * Split treap t into the treaps of the values < value and >= value
+     */
+    std::pair<std::uint32_t, std::uint32_t> split(std::uint32_t t, int value);
+
+    /*
+     * Join treaps a and b, all values of a being smaller than those of b
+     */
+    std::uint32_t merge(std::uint32_t a, std::uint32_t b);
+
+    /*
+     * Remove the smallest value of treap t, return the new root of t
+     */
+    std::uint32_t remove_min(std::uint32_t t);
+};
@@ -0,0 +1,85 @@
+#include "parallel_merge.h"
+#include "set_merge.h"
+
+#include <algorithm>
+
+namespace {
+/*
+ * Co-rank of diagonal d: return i such that the first d values of the merge of A and B
+ * are A[0, i) and B[0, d - i), taking the values of A first when A and B have equal values
+ */
+size_t co_rank(size_t d, std::span<const int> A, std::span<const int> B) {
+    size_t lo = (d > B.size()) ? d - B.size() : 0;
+    size_t hi = std::min(d, A.size());
+
+    while (lo < hi) {  // O(log(|A| + |B|))
+        const size_t i = lo + (hi - lo) / 2;
+        if (A[i] <= B[d - i - 1]) {
+            lo = i + 1;  // A[i] comes before B[d-i-1] in the merge: take more values of A
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+/*
+ * Merge A and B in n_threads slices, keep decides which values belong to the result
+ */
+template <typename Keep>
+std::vector<int> merge_path(std::span<const int> A, std::span<const int> B, unsigned n_threads, Keep keep) {
+    if (n_threads <= 1 || A.size() + B.size() < parallel_cutoff) {
+        return merge_sorted(A, B, keep);
+    }
+
+    // Cuts: slice k is A[a[k], a[k+1]) and B[b[k], b[k+1])
+    std::vector<size_t> a(n_threads + 1), b(n_threads + 1);
+    const size_t total = A.size() + B.size();
+    for (unsigned k = 0; k <= n_threads; ++k) {
+        const size_t d = total * k / n_threads;
+        a[k] = co_rank(d, A, B);
+        b[k] = d - a[k];
+
+        // An equal pair A[a-1] == B[b] would be split between two slices: move B[b] to the left slice
+        if (a[k] > 0 && b[k] < B.size() && A[a[k] - 1] == B[b[k]]) {
+            ++b[k];
+        }
+    }
+
+    std::vector<std::vector<int>> slices(n_threads);
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned k = 0; k < n_threads; ++k) {
+            workers.emplace_back([&, k] {
+                slices[k] = merge_sorted(A.subspan(a[k], a[k + 1] - a[k]), B.subspan(b[k], b[k + 1] - b[k]), keep);
+            });
+        }
+    }
+
+    std::vector<size_t> offsets(n_threads + 1, 0);
+    for (unsigned k = 0; k < n_threads; ++k) {
+        offsets[k + 1] = offsets[k] + slices[k].size();
+    }
+
+    std::vector<int> result(offsets[n_threads]);
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned k = 0; k < n_threads; ++k) {
+            workers.emplace_back([&, k] { std::ranges::copy(slices[k], result.begin() + offsets[k]); });
+        }
+    }
+    return result;
+}
+}  // namespace
+
+std::vector<int> parallel_union(std::span<const int> A, std::span<const int> B, unsigned n_threads) {
+    return merge_path(A, B, n_threads, keep_union);
+}
+
+std::vector<int> parallel_intersection(std::span<const int> A, std::span<const int> B, unsigned n_threads) {
+    return merge_path(A, B, n_threads, keep_intersection);
+}
+
+std::vector<int> parallel_difference(std::span<const int> A, std::span<const int> B, unsigned n_threads) {
+    return merge_path(A, B, n_threads, keep_difference);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <span>
+#include <thread>
+#include <vector>
+
+/*
+ * Set operations on very large Sets stored contiguously, as sorted arrays of unique ints
+ * (e.g. a std::vector<int> or the values of a Set read into one)
+ *
+ * Both inputs are cut into n_threads pairs of slices with merge-path partitioning:
+ * the k-th cut is the co-rank of the diagonal k * (|A| + |B|) / n_threads, found by binary search,
+ * so every thread merges the same number of input values
+ * Each thread merges its pair of slices into its own buffer, and the buffers are then
+ * concatenated in order, which gives the same result as a sequential merge
+ *
+ * Inputs smaller than parallel_cutoff values, or n_threads <= 1, are merged sequentially
+ */
+inline constexpr size_t parallel_cutoff = size_t{1} << 15;
+
+std::vector<int> parallel_union(std::span<const int> A, std::span<const int> B,
+                                unsigned n_threads = std::thread::hardware_concurrency());
+
+std::vector<int> parallel_intersection(std::span<const int> A, std::span<const int> B,
+                                       unsigned n_threads = std::thread::hardware_concurrency());
+
+std::vector<int> parallel_difference(std::span<const int> A, std::span<const int> B,
+                                     unsigned n_threads = std::thread::hardware_concurrency());
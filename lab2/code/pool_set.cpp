@@ -0,0 +1,254 @@
+#include "pool_set.h"
+
+#include <algorithm>
+#include <utility>
+
+/*****************************************************
+ * Construction                                       *
+ ******************************************************/
+
+/*
+ * Move constructor: take the pool of P, which becomes an empty PoolSet
+ */
+PoolSet::PoolSet(PoolSet&& P) noexcept
+    : pool{std::move(P.pool)}, free_list{std::exchange(P.free_list, none)}, counter{std::exchange(P.counter, 0)} {
+    P.pool.clear();
+}
+
+/*
+ * Move assignment operator: take the pool of P, which becomes an empty PoolSet
+ */
+PoolSet& PoolSet::operator=(PoolSet&& P) noexcept {
+    if (this != &P) {
+        pool = std::move(P.pool);
+        free_list = std::exchange(P.free_list, none);
+        counter = std::exchange(P.counter, 0);
+        P.pool.clear();
+    }
+    return *this;
+}
+
+/*
+ * Create a PoolSet storing the values of Set S
+ */
+PoolSet::PoolSet(const Set& S) : PoolSet{std::vector<int>(S.begin(), S.end())} {
+}
+
+/*
+ * Create a PoolSet storing the sorted unique ints in values
+ * The Slots are stored in the order of the list
+ */
+PoolSet::PoolSet(std::span<const int> values) : PoolSet{} {
+    pool.reserve(values.size() + 2);
+    for (int val : values) {
+        insert_slot(tail, val);
+    }
+}
+
+/*****************************************************
+ * Queries                                            *
+ ******************************************************/
+
+/*
+ * Test whether val belongs to the Set
+ */
+bool PoolSet::is_member(int val) const {
+    const std::uint32_t p = lower_bound(val);
+    return p != tail && pool[p].value == val;
+}
+
+PoolSet::const_iterator PoolSet::begin() const {
+    const_iterator it{};
+    it.set = this;
+    it.index = first();
+    return it;
+}
+
+PoolSet::const_iterator PoolSet::end() const {
+    const_iterator it{};
+    it.set = this;
+    it.index = tail;
+    return it;
+}
+
+/*
+ * Return the number of bytes used by the PoolSet, including its pool
+ */
+size_t PoolSet::memory_bytes() const {
+    return sizeof(*this) + pool.capacity() * sizeof(Slot);
+}
+
+/*
+ * Create a Set with the values of the PoolSet
+ */
+Set PoolSet::to_set() const {
+    return Set{std::vector<int>(begin(), end())};
+}
+
+bool PoolSet::operator==(const PoolSet& P) const {
+    return counter == P.counter && std::equal(begin(), end(), P.begin());
+}
+
+/*****************************************************
+ * Modifications                                      *
+ ******************************************************/
+
+/*
+ * Insert val, return false if it already belonged to the Set
+ */
+bool PoolSet::insert(int val) {
+    const std::uint32_t p = lower_bound(val);
+    if (p != tail && pool[p].value == val) {
+        return false;
+    }
+    insert_slot(p, val);
+    return true;
+}
+
+/*
+ * Remove val, return false if it did not belong to the Set
+ */
+bool PoolSet::erase(int val) {
+    const std::uint32_t p = lower_bound(val);
+    if (p == tail || pool[p].value != val) {
+        return false;
+    }
+    remove_slot(p);
+    return true;
+}
+
+/*
+ * Store the Slots in the order of the list and release the free Slots
+ */
+void PoolSet::compact() {
+    PoolSet P{};
+    P.pool.reserve(counter + 2);
+    for (int val : *this) {
+        P.insert_slot(tail, val);
+    }
+    *this = std::move(P);
+}
+
+/*
+ * Modify Set *this such that it becomes the union of *this with Set P
+ */
+PoolSet& PoolSet::operator+=(const PoolSet& P) {
+    std::uint32_t p = first();
+    std::uint32_t q = P.first();
+
+    while (p != tail && q != tail) {
+        if (pool[p].value < P.pool[q].value) {
+            p = pool[p].next;
+        } else if (pool[p].value > P.pool[q].value) {
+            insert_slot(p, P.pool[q].value);
+            q = P.pool[q].next;
+        } else {
+            p = pool[p].next;
+            q = P.pool[q].next;
+        }
+    }
+
+    for (; q != tail; q = P.pool[q].next) {
+        insert_slot(tail, P.pool[q].value);
+    }
+    return *this;
+}
+
+/*
+ * Modify Set *this such that it becomes the intersection of *this with Set P
+ */
+PoolSet& PoolSet::operator*=(const PoolSet& P) {
+    std::uint32_t p = first();
+    std::uint32_t q = P.first();
+
+    while (p != tail && q != tail) {
+        if (pool[p].value < P.pool[q].value) {
+            p = pool[p].next;
+            remove_slot(pool[p].prev);
+        } else if (pool[p].value > P.pool[q].value) {
+            q = P.pool[q].next;
+        } else {
+            p = pool[p].next;
+            q = P.pool[q].next;
+        }
+    }
+
+    while (p != tail) {
+        p = pool[p].next;
+        remove_slot(pool[p].prev);
+    }
+    return *this;
+}
+
+/*
+ * Modify Set *this such that it becomes the Set difference *this - P
+ */
+PoolSet& PoolSet::operator-=(const PoolSet& P) {
+    std::uint32_t p = first();
+    std::uint32_t q = P.first();
+
+    while (p != tail && q != tail) {
+        if (pool[p].value < P.pool[q].value) {
+            p = pool[p].next;
+        } else if (pool[p].value > P.pool[q].value) {
+            q = P.pool[q].next;
+        } else {
+            p = pool[p].next;
+            q = P.pool[q].next;
+            remove_slot(pool[p].prev);
+        }
+    }
+    return *this;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Insert a Slot storing val before Slot p, reusing a free Slot if any
+ * The dummy Slots are created first if the pool is empty (then p is tail)
+ */
+void PoolSet::insert_slot(std::uint32_t p, int val) {
+    if (pool.empty()) {
+        pool.assign({Slot{0, tail, none}, Slot{0, none, head}});
+    }
+
+    const std::uint32_t prev = pool[p].prev;
+    std::uint32_t s = free_list;
+
+    if (s != none) {
+        free_list = pool[s].next;
+        pool[s] = Slot{val, p, prev};
+    } else {
+        s = static_cast<std::uint32_t>(pool.size());
+        pool.push_back(Slot{val, p, prev});
+    }
+
+    pool[prev].next = s;
+    pool[p].prev = s;
+    ++counter;
+}
+
+/*
+ * Unlink Slot p and add it to the free list
+ */
+void PoolSet::remove_slot(std::uint32_t p) {
+    pool[pool[p].prev].next = pool[p].next;
+    pool[pool[p].next].prev = pool[p].prev;
+
+    pool[p].next = free_list;
+    free_list = p;
+    --counter;
+}
+
+/*
+ * Return the first Slot with a value >= val, or tail if none
+ */
+std::uint32_t PoolSet::lower_bound(int val) const {
+    std::uint32_t p = first();
+    while (p != tail && pool[p].value < val) {
+        p = pool[p].next;
+    }
+    return p;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "set.h"
+
+/** Class to represent a Set of ints as a sorted doubly linked list stored in one pool
+ *
+ * PoolSet has the same structure as Set, but all its Nodes (Slots) live in one contiguous
+ * vector and are linked with 32-bit indices instead of pointers: a Slot takes 12 bytes,
+ * without a heap allocation per value
+ * Slots of removed values are kept in a free list and reused by later insertions
+ * Copying a PoolSet copies the vector of Slots in one block, the indices stay valid
+ *
+ * compact() stores the Slots in the order of the list, so that traversals read memory sequentially
+ *
+ * An empty pool is an empty PoolSet: the two dummy Slots are created by the first insertion,
+ * so that default construction and moves do not allocate
+ */
+class PoolSet {
+    struct Slot {
+        int value;
+        std::uint32_t next;  // index of the next Slot in the list, or of the next free Slot
+        std::uint32_t prev;  // index of the previous Slot in the list
+    };
+
+public:
+    /*
+     * Bidirectional iterator over the values of a PoolSet, in increasing order
+     * Invalidated only when the value it refers to is removed, or by compact()
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return set->pool[index].value;
+        }
+
+        const_iterator& operator++() {
+            index = set->pool[index].next;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator it{*this};
+            ++*this;
+            return it;
+        }
+
+        const_iterator& operator--() {
+            index = set->pool[index].prev;
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            const_iterator it{*this};
+            --*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& it) const = default;
+
+    private:
+        friend class PoolSet;
+
+        const PoolSet* set{nullptr};
+        std::uint32_t index{0};  // Slot storing the value, or the dummy tail Slot for end()
+    };
+
+    /*
+     * Default constructor: create an empty PoolSet, without allocating
+     */
+    PoolSet() = default;
+
+    /*
+     * Create a PoolSet storing the values of Set S
+     */
+    explicit PoolSet(const Set& S);
+
+    /*
+     * Create a PoolSet storing the sorted unique ints in values
+     */
+    explicit PoolSet(std::span<const int> values);
+
+    PoolSet(const PoolSet&) = default;
+    PoolSet& operator=(const PoolSet&) = default;
+
+    /*
+     * Move constructor: take the pool of P, which becomes an empty PoolSet
+     */
+    PoolSet(PoolSet&& P) noexcept;
+
+    /*
+     * Move assignment operator: take the pool of P, which becomes an empty PoolSet
+     */
+    PoolSet& operator=(PoolSet&& P) noexcept;
+
+    size_t cardinality() const {
+        return counter;
+    }
+
+    bool is_empty() const {
+        return counter == 0;
+    }
+
+    /*
+     * Test whether val belongs to the Set
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Insert val, return false if it already belonged to the Set
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val, return false if it did not belong to the Set
+     * The Slot of val is reused by a later insertion
+     */
+    bool erase(int val);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Store the Slots in the order of the list and release the free Slots
+     */
+    void compact();
+
+    /*
+     * Return the number of bytes used by the PoolSet, including its pool
+     */
+    size_t memory_bytes() const;
+
+    /*
+     * Create a Set with the values of the PoolSet
+     */
+    Set to_set() const;
+
+    bool operator==(const PoolSet& P) const;
+
+    /*
+     * Union, intersection and difference: a single merge, as for Set
+     */
+    PoolSet& operator+=(const PoolSet& P);
+    PoolSet& operator*=(const PoolSet& P);
+    PoolSet& operator-=(const PoolSet& P);
+
+    friend PoolSet operator+(PoolSet P1, const PoolSet& P2) {
+        return (P1 += P2);
+    }
+
+    friend PoolSet operator*(PoolSet P1, const PoolSet& P2) {
+        return (P1 *= P2);
+    }
+
+    friend PoolSet operator-(PoolSet P1, const PoolSet& P2) {
+        return (P1 -= P2);
+    }
+
+private:
+    static constexpr std::uint32_t head = 0;  // index of the dummy header Slot
+    static constexpr std::uint32_t tail = 1;  // index of the dummy tail Slot
+    static constexpr std::uint32_t none = UINT32_MAX;
+
+    std::vector<Slot> pool;           // empty, or pool[head], pool[tail], then the values and the free Slots
+    std::uint32_t free_list{none};    // first free Slot, linked through next
+    size_t counter{0};                // number of values in the Set
+
+    /*
+     * Return the first Slot of the list, or tail if the Set is empty
+     */
+    std::uint32_t first() const {
+        return pool.empty() ? tail : pool[head].next;
+    }
+
+    /*
+     * Insert a Slot storing val before Slot p
+     * The dummy Slots are created first if the pool is empty
+     */
+    void insert_slot(std::uint32_t p, int val);
+
+    /*
+     * Unlink Slot p and add it to the free list
+     */
+    void remove_slot(std::uint32_t p);
+
+    /*
+     * Return the first Slot with a value >= val, or tail if none
+     */
+    std::uint32_t lower_bound(int val) const;
+};
+
+static_assert(std::bidirectional_iterator<PoolSet::const_iterator>);
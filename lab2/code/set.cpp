@@ -1,30 +1,51 @@
 #include "set.h"
-#include "node.h"
-
-int Set::Node::count_nodes = 0;
+#include "set_merge.h"
+#include "bloom_filter.h"
+#include "order_index.h"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <execution>
+#include <functional>
+#include <locale>
+#include <queue>
 
 /*****************************************************
  * Implementation of the member functions             *
  ******************************************************/
 
 /*
- *  Default constructor :create an empty Set
+ * Return number of existing nodes
  */
 int Set::get_count_nodes() {
-    return Set::Node::count_nodes;
+    const long long n = NodeCounters::total(NodeCounters::live_nodes);
+    assert(n >= 0);  // number of existing nodes can never be negative
+    return static_cast<int>(n);
+}
+
+/*
+ * Return the current statistics
+ */
+Set::Statistics Set::get_statistics() {
+    return Statistics{NodeCounters::total(NodeCounters::live_nodes),
+                      NodeCounters::total(NodeCounters::allocations),
+                      NodeCounters::total(NodeCounters::bytes),
+                      NodeCounters::total(NodeCounters::peak_live_nodes),
+                      NodeCounters::total(NodeCounters::union_steps),
+                      NodeCounters::total(NodeCounters::intersection_steps),
+                      NodeCounters::total(NodeCounters::difference_steps)};
 }
 
 /*
  *  Default constructor :create an empty Set
+ *  The dummy Nodes are embedded in the Set: no memory is allocated
  */
 Set::Set() : counter{0} {
     // IMPLEMENT before Lab2 HA
-    
-    head = new Node();          // O(1)
-    tail = new Node();          // O(1)
 
-    head->next = tail;          // O(1)
-    tail->prev = head;          // O(1)
+    head.next = &tail;          // O(1)
+    tail.prev = &head;          // O(1)
 }
 
 /*
@@ -33,7 +54,7 @@ Set::Set() : counter{0} {
 Set::Set(int val) : Set{} {  // create an empty list
     // IMPLEMENT before Lab2 HA
     
-    insert_node(tail, val);             // O(1)
+    insert_node(&tail, val);             // O(1)
 }
 
 /*
@@ -43,10 +64,21 @@ Set::Set(int val) : Set{} {  // create an empty list
 Set::Set(const std::vector<int>& list_of_values) : Set{} {  // create an empty list
     // IMPLEMENT before Lab2 HA
     
-    for (size_t e : list_of_values)     // O(n)
-    {
-        insert_node(tail, e);
-    }
+    append_sorted(list_of_values);      // O(n)
+}
+
+/*
+ * Create a Set from a vector of ints in any order, possibly with repetitions
+ * The values are sorted and the repetitions removed in parallel,
+ * then the list is linked in a single pass
+ */
+Set Set::from_unsorted(std::vector<int> values) {
+    std::sort(std::execution::par_unseq, values.begin(), values.end());    // O(n log n)
+    values.erase(std::unique(std::execution::par, values.begin(), values.end()), values.end());
+
+    Set S{};
+    S.append_sorted(values);            // O(n)
+    return S;
 }
 
 /*
@@ -56,13 +88,34 @@ Set::Set(const std::vector<int>& list_of_values) : Set{} {  // create an empty l
  */
 Set::Set(const Set& S) : Set{} {  // create an empty list
     // IMPLEMENT before Lab2 HA
-    
-    Node* ptr = S.head->next; // First Node after dummy
-    while (ptr != S.tail)               // O(n)
+
+    Node* block = allocate_nodes(S.counter);  // one allocation for all Nodes
+    Node* last = &head;
+    Node* ptr = S.head.next; // First Node after dummy
+    while (ptr != &S.tail)               // O(n)
     {
-        insert_node(tail, ptr->value);
+        last = last->next = Node::create_in_block(block++, ptr->value, &tail, last);
         ptr = ptr->next;
     }
+    tail.prev = last;
+    counter = S.counter;
+    fingerprint = S.fingerprint;
+
+    if (S.bloom) {
+        bloom = std::make_unique<BloomFilter>(*S.bloom);
+    }
+    if (S.order_index) {
+        order_index = std::make_unique<OrderIndex>();
+        rebuild_order_index();
+    }
+}
+
+/*
+ * Move constructor: take the Nodes of S, which becomes empty
+ * Only the first and last Nodes are relinked to the dummy Nodes of *this: O(1)
+ */
+Set::Set(Set&& S) noexcept : Set{} {
+    swap(S);
 }
 
 /*
@@ -72,15 +125,27 @@ Set::Set(const Set& S) : Set{} {  // create an empty list
 void Set::make_empty() {
     // IMPLEMENT before Lab2 HA
 
-    Node* ptr = head->next;
-    while (ptr != tail)             // O(n)
+    std::unique_ptr<OrderIndex> index = std::move(order_index);  // emptied at once below
+
+    Node* ptr = head.next;
+    while (ptr != &tail)             // O(n)
     {
         ptr = ptr->next;
         remove_node(ptr->prev);
     }
 
-    head->next = tail;  // or ptr?
-    tail->prev = head;
+    head.next = &tail;  // or ptr?
+    tail.prev = &head;
+    release_blocks();
+
+    if (index) {
+        index->reset();
+        order_index = std::move(index);
+    }
+
+    if (bloom) {
+        rebuild_bloom_filter();
+    }
 }
 
 /*
@@ -89,9 +154,9 @@ void Set::make_empty() {
 Set::~Set() {
     // IMPLEMENT before Lab2 HA
 
-    make_empty();       // O(n)
-    remove_node(head);  // O(1)
-    remove_node(tail);  // O(1)
+    bloom.reset();      // make_empty must not rebuild the filter
+    order_index.reset();
+    make_empty();       // O(n), the dummy Nodes are destroyed with the Set
 }
 
 /*
@@ -102,12 +167,27 @@ Set::~Set() {
 Set& Set::operator=(Set S) {
     // IMPLEMENT before Lab2 HA
 
-    counter = S.counter;        // O(1)
-    std::swap(head, S.head);    // O(1)
-    std::swap(tail, S.tail);    // O(1)
+    swap(S);                    // O(1)
     return *this;
 }
 
+/*
+ * Exchange the values of *this and S: O(1)
+ */
+void Set::swap(Set& S) noexcept {
+    std::swap(head.next, S.head.next);
+    std::swap(tail.prev, S.tail.prev);
+    relink_dummies(S);
+    S.relink_dummies(*this);
+
+    std::swap(counter, S.counter);
+    std::swap(fingerprint, S.fingerprint);
+    std::swap(order_index, S.order_index);
+    std::swap(bloom, S.bloom);
+    std::swap(blocks, S.blocks);
+    std::swap(free_nodes, S.free_nodes);
+}
+
 /*
  * Test whether val belongs to the Set
  * Return true if val belongs to the set, otherwise false
@@ -116,17 +196,194 @@ Set& Set::operator=(Set S) {
 bool Set::is_member(int val) const {
     // IMPLEMENT before Lab2 HA
 
-    Node* ptr = head->next;
-    while (ptr != tail)
-    {
-        if (ptr->value == val)
-        {
-            return true;
-        }
+    if (bloom && !bloom->may_contain(val)) {
+        return false;  // no false negatives: val does not belong to the Set
+    }
+    return find(val) != end();  // the list is sorted: stop at the first value >= val
+}
+
+/*
+ * Attach a blocked Bloom filter to the Set, with bits_per_value bits per value
+ */
+void Set::enable_bloom_filter(double bits_per_value) {
+    bloom = std::make_unique<BloomFilter>(2 * counter, bits_per_value);
+    rebuild_bloom_filter();
+}
+
+/*
+ * Remove the Bloom filter of the Set, if any
+ */
+void Set::disable_bloom_filter() {
+    bloom.reset();
+}
+
+size_t Set::bloom_filter_bytes() const {
+    return bloom ? bloom->memory_bytes() : 0;
+}
+
+double Set::bloom_filter_false_positive_rate() const {
+    return bloom ? bloom->false_positive_rate() : 1.0;
+}
+
+/*
+ * Attach an order-statistic index to the Set, filled in O(n)
+ */
+void Set::enable_order_index() {
+    if (!order_index) {
+        order_index = std::make_unique<OrderIndex>();
+        rebuild_order_index();
+    }
+}
+
+/*
+ * Remove the order-statistic index of the Set, if any
+ */
+void Set::disable_order_index() {
+    order_index.reset();
+}
+
+/*
+ * Return an iterator to the smallest value of the Set not less than val, or end() if none
+ * O(log n) with the order-statistic index, otherwise O(n)
+ */
+Set::const_iterator Set::lower_bound(int val) const {
+    if (order_index) {
+        const Node* p = order_index->lower_bound(val);
+        return (p != nullptr) ? const_iterator{p} : end();
+    }
+
+    const Node* ptr = head.next;
+    while (ptr != &tail && ptr->value < val) {  // the list is sorted: stop at the first value >= val
         ptr = ptr->next;
     }
+    return const_iterator{ptr};
+}
+
+/*
+ * Return the number of values of the Set smaller than val
+ * O(log n) with the order-statistic index, otherwise O(n)
+ */
+size_t Set::rank(int val) const {
+    if (order_index) {
+        return order_index->rank(val);
+    }
 
-    return false;  // remove this line
+    size_t r = 0;
+    for (const Node* ptr = head.next; ptr != &tail && ptr->value < val; ptr = ptr->next) {
+        ++r;
+    }
+    return r;
+}
+
+/*
+ * Return an iterator to the k-th smallest value of the Set, or end() if k >= cardinality()
+ * O(log n) with the order-statistic index, otherwise O(k)
+ */
+Set::const_iterator Set::select(size_t k) const {
+    if (k >= counter) {
+        return end();
+    }
+    if (order_index) {
+        return const_iterator{order_index->select(k)};
+    }
+
+    const Node* ptr = head.next;
+    for (; k > 0; --k) {
+        ptr = ptr->next;
+    }
+    return const_iterator{ptr};
+}
+
+/*
+ * Return the number of values of the Set in the range [a, b]
+ * O(log n) with the order-statistic index: two ranks, otherwise O(n)
+ */
+size_t Set::count_range(int a, int b) const {
+    if (a > b) {
+        return 0;
+    }
+    const size_t below_b = (b == INT_MAX) ? counter : rank(b + 1);
+    return below_b - rank(a);
+}
+
+/*
+ * Return an iterator to val, or end() if val does not belong to the Set
+ */
+Set::const_iterator Set::find(int val) const {
+    const const_iterator it = lower_bound(val);
+    return (it != end() && *it == val) ? it : end();
+}
+
+/*
+ * Insert val, return false if it already belonged to the Set
+ */
+bool Set::insert(int val) {
+    const size_t n = counter;
+    insert(begin(), val);
+    return counter != n;
+}
+
+/*
+ * Insert val using hint as a starting position, return an iterator to val
+ */
+Set::const_iterator Set::insert(const_iterator hint, int val) {
+    Node* ptr = const_cast<Node*>(hint.ptr);
+
+    // Find the first Node with a value >= val, the values before it are < val
+    while (ptr != &tail && ptr->value < val) {
+        ptr = ptr->next;
+    }
+    while (ptr->prev != &head && ptr->prev->value >= val) {
+        ptr = ptr->prev;
+    }
+
+    if (ptr != &tail && ptr->value == val) {
+        return const_iterator{ptr};
+    }
+    insert_node(ptr, val);
+    return const_iterator{ptr->prev};
+}
+
+/*
+ * Remove val, return false if it did not belong to the Set
+ */
+bool Set::erase(int val) {
+    const const_iterator it = find(val);
+    if (it == end()) {
+        return false;
+    }
+    erase(it);
+    return true;
+}
+
+/*
+ * Remove the value at pos, return an iterator to the following value
+ */
+Set::const_iterator Set::erase(const_iterator pos) {
+    Node* ptr = const_cast<Node*>(pos.ptr);
+    const const_iterator next{ptr->next};
+    remove_node(ptr);  // a Bloom filter keeps the removed value until it is rebuilt
+    return next;
+}
+
+/*
+ * Count the number of values in the intersection of *this and S
+ */
+size_t Set::intersection_size(const Set& S) const {
+    if (is_empty() || S.is_empty() || tail.prev->value < S.head.next->value ||
+        S.tail.prev->value < head.next->value) {
+        return 0;  // the ranges of values do not overlap
+    }
+    return count_common(*this, S);
+}
+
+/*
+ * Return the Jaccard similarity |*this * S| / |*this + S|, 1 if both Sets are empty
+ */
+double Set::jaccard(const Set& S) const {
+    const size_t common = intersection_size(S);
+    const size_t all = counter + S.counter - common;
+    return (all == 0) ? 1.0 : static_cast<double>(common) / static_cast<double>(all);
 }
 
 /*
@@ -137,16 +394,16 @@ bool Set::is_member(int val) const {
 bool Set::operator==(const Set& S) const {
     // IMPLEMENT before Lab2 HA
 
-    if (counter != S.counter)
+    if (counter != S.counter || fingerprint != S.fingerprint)
     {
-        return false;
+        return false;  // O(1)
     }
 
-    Node* ptr = head->next;
-    Node* ptr_s = S.head->next;
+    Node* ptr = head.next;
+    Node* ptr_s = S.head.next;
 
 
-    while (ptr != tail && ptr_s != S.tail)
+    while (ptr != &tail && ptr_s != &S.tail)
     {
         if (ptr->value != ptr_s->value)
         {
@@ -161,80 +418,92 @@ bool Set::operator==(const Set& S) const {
 }
 
 /*
- * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
- * Return std::partial_ordering::equivalent, if *this == S
- * Return std::partial_ordering::less, if *this < S
- * Return std::partial_ordering::greater, if *this > S
- * Return std::partial_ordering::unordered, otherwise
+ * Test whether every value of *this belongs to Set S
  */
-std::partial_ordering Set::operator<=>(const Set& S) const {
-    // IMPLEMENT before Lab2 HA
+bool Set::is_subset_of(const Set& S) const {
+    if (counter > S.counter)
+    {
+        return false;
+    }
+    if (is_empty())
+    {
+        return true;
+    }
+    if (head.next->value < S.head.next->value || tail.prev->value > S.tail.prev->value)
+    {
+        return false;  // a value of *this is out of the range of S
+    }
 
-    Node* ptr = head->next;
-    Node* ptr_s = S.head->next;
+    // S has a value >= each value of *this, so ptr_s never reaches &S.tail
+    Node* ptr_s = S.head.next;
+    size_t remaining_s = S.counter;
+    size_t remaining = counter;
 
-    // If all elements in S are found in *this      [greater]
-    if (this->counter > S.counter)
+    for (Node* ptr = head.next; ptr != &tail; ptr = ptr->next, --remaining)
     {
-        while (ptr_s != S.tail)
+        while (ptr_s->value < ptr->value)
         {
-            if (ptr->value != ptr_s->value)
-            {
-                ptr = ptr->next;
-            }
-            else
-            {
-                ptr = ptr->next;
-                ptr_s = ptr_s->next;    // no duplicates so its ok.
-            }
-
-            if (ptr == tail)
+            ptr_s = ptr_s->next;
+            if (--remaining_s < remaining)
             {
-                return std::partial_ordering::unordered;
+                return false;  // too few values left in S
             }
+        }
 
-            if (ptr_s == S.tail)
-            {
-                return std::partial_ordering::greater;
-            }
+        if (ptr_s->value != ptr->value)
+        {
+            return false;
         }
+        ptr_s = ptr_s->next;
+        --remaining_s;
     }
 
-    // If no elements in S are found in *this       [less]
-    if (this->counter < S.counter)
-    {
-        while (ptr != tail)
-        {
-            if (ptr->value != ptr_s->value)
-            {
-                ptr_s = ptr_s->next;
-            }
-            else
-            {
-                ptr = ptr->next;
-                ptr_s = ptr_s->next;    // no duplicates so its ok.
-            }
+    return true;
+}
 
-            if (ptr_s == S.tail)
-            {
-                return std::partial_ordering::unordered;
-            }
+/*
+ * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
+ * Return std::partial_ordering::equivalent, if *this == S
+ * Return std::partial_ordering::less, if *this < S
+ * Return std::partial_ordering::greater, if *this > S
+ * Return std::partial_ordering::unordered, otherwise
+ */
+std::partial_ordering Set::operator<=>(const Set& S) const {
+    // IMPLEMENT before Lab2 HA
 
-            if (ptr == tail)
-            {
-                return std::partial_ordering::less;
-            }
-        }
+    if (counter == S.counter)
+    {
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
     }
 
-    // If elements in S are the same as in *this    [equivalent]
-    if (*this == S)
+    // If all elements in *this are found in S      [less]
+    if (counter < S.counter)
     {
-        return std::partial_ordering::equivalent;
+        return is_subset_of(S) ? std::partial_ordering::less : std::partial_ordering::unordered;
     }
 
-    // Otherwise [unordered]
-    return std::partial_ordering::unordered;
+    // If all elements in S are found in *this      [greater]
+    return S.is_subset_of(*this) ? std::partial_ordering::greater : std::partial_ordering::unordered;
+}
+
+/*
+ * Test whether *this is the singleton {val}
+ */
+bool Set::operator==(int val) const {
+    return counter == 1 && head.next->value == val;
+}
+
+/*
+ * Compare *this with the singleton {val}: at most one search for val
+ */
+std::partial_ordering Set::operator<=>(int val) const {
+    if (counter == 0) {
+        return std::partial_ordering::less;
+    }
+    if (counter == 1) {
+        return (head.next->value == val) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+    }
+    return is_member(val) ? std::partial_ordering::greater : std::partial_ordering::unordered;
 }
 
 /*
@@ -243,35 +512,42 @@ std::partial_ordering Set::operator<=>(const Set& S) const {
  */
 Set& Set::operator+=(const Set& S) {
     // IMPLEMENT
-    Node* ptr = head->next;
-    Node* ptr_s = S.head->next;
-    
-    while (ptr != tail && ptr_s != S.tail)
+    std::unique_ptr<OrderIndex> index = std::move(order_index);  // rebuilt after the merge
+    Node* ptr = head.next;
+    Node* ptr_s = S.head.next;
+    long long steps = 0;
+
+    while (ptr != &tail && ptr_s != &S.tail)
     {
+        ++steps;
         if (ptr->value < ptr_s->value)
         {
             ptr = ptr->next;
         }
-
-        if (ptr->value > ptr_s->value)
+        else if (ptr->value > ptr_s->value)
         {
             insert_node(ptr, ptr_s->value);
             ptr_s = ptr_s->next;
         }
-
-        if (ptr->value == ptr_s->value)
+        else
         {
             ptr = ptr->next;
             ptr_s = ptr_s->next;
         }
     }
 
-    while (ptr_s != S.tail)
+    while (ptr_s != &S.tail)
     {
+        ++steps;
         insert_node(ptr, ptr_s->value);
         ptr_s = ptr_s->next;
     }
 
+    NodeCounters::add(NodeCounters::union_steps, steps);
+    if (index) {
+        order_index = std::move(index);
+        rebuild_order_index();
+    }
     return *this;
 }
 
@@ -281,36 +557,46 @@ Set& Set::operator+=(const Set& S) {
  */
 Set& Set::operator*=(const Set& S) {
     // IMPLEMENT
+    std::unique_ptr<OrderIndex> index = std::move(order_index);  // rebuilt after the merge
 
-    Node* ptr = head->next;
-    Node* ptr_s = S.head->next;
+    Node* ptr = head.next;
+    Node* ptr_s = S.head.next;
+    long long steps = 0;
 
-    while (ptr != tail && ptr_s != S.tail)
+    while (ptr != &tail && ptr_s != &S.tail)
     {
+        ++steps;
         if (ptr->value < ptr_s->value)
         {
             ptr = ptr->next;
             remove_node(ptr->prev);
         }
-
-        if (ptr->value > ptr_s->value)
+        else if (ptr->value > ptr_s->value)
         {
             ptr_s = ptr_s->next;
         }
-
-        if (ptr->value == ptr_s->value)
+        else
         {
             ptr = ptr->next;
             ptr_s = ptr_s->next;
         }
     }
 
-    while (ptr != tail)
+    while (ptr != &tail)
     {
+        ++steps;
         ptr = ptr->next;
         remove_node(ptr->prev);
     }
 
+    NodeCounters::add(NodeCounters::intersection_steps, steps);
+    if (bloom) {
+        rebuild_bloom_filter();  // a Bloom filter cannot forget values
+    }
+    if (index) {
+        order_index = std::move(index);
+        rebuild_order_index();
+    }
     return *this;
 }
 
@@ -320,23 +606,24 @@ Set& Set::operator*=(const Set& S) {
  */
 Set& Set::operator-=(const Set& S) {
     // IMPLEMENT
+    std::unique_ptr<OrderIndex> index = std::move(order_index);  // rebuilt after the merge
 
-    Node* ptr = head->next;
-    Node* ptr_s = S.head->next;
+    Node* ptr = head.next;
+    Node* ptr_s = S.head.next;
+    long long steps = 0;
 
-    while (ptr != tail && ptr_s != S.tail)
+    while (ptr != &tail && ptr_s != &S.tail)
     {
+        ++steps;
         if (ptr->value < ptr_s->value)
         {
             ptr = ptr->next;
         }
-
-        if (ptr->value > ptr_s->value)
+        else if (ptr->value > ptr_s->value)
         {
             ptr_s = ptr_s->next;
         }
-
-        if (ptr->value == ptr_s->value)
+        else
         {
             ptr = ptr->next;
             ptr_s = ptr_s->next;
@@ -344,9 +631,132 @@ Set& Set::operator-=(const Set& S) {
         }
     }
 
+    NodeCounters::add(NodeCounters::difference_steps, steps);
+    if (bloom) {
+        rebuild_bloom_filter();
+    }
+    if (index) {
+        order_index = std::move(index);
+        rebuild_order_index();
+    }
     return *this;
 }
 
+/*
+ * Union with the singleton {val}: insert val
+ */
+Set& Set::operator+=(int val) {
+    insert(val);
+    return *this;
+}
+
+/*
+ * Intersection with the singleton {val}: remove all values but val
+ */
+Set& Set::operator*=(int val) {
+    std::unique_ptr<OrderIndex> index = std::move(order_index);  // rebuilt after the merge
+    Node* ptr = head.next;
+    while (ptr != &tail) {
+        ptr = ptr->next;
+        if (ptr->prev->value != val) {
+            remove_node(ptr->prev);
+        }
+    }
+
+    if (bloom) {
+        rebuild_bloom_filter();
+    }
+    if (index) {
+        order_index = std::move(index);
+        rebuild_order_index();
+    }
+    return *this;
+}
+
+/*
+ * Difference with the singleton {val}: erase val
+ */
+Set& Set::operator-=(int val) {
+    erase(val);
+    return *this;
+}
+
+/*
+ * Return the union of all Sets in sets, without intermediate Sets
+ */
+Set Set::union_all(std::span<const Set> sets) {
+    Set R{};
+    std::vector<const_iterator> cursors;
+    std::priority_queue<std::pair<int, size_t>, std::vector<std::pair<int, size_t>>, std::greater<>> heap;
+
+    for (size_t k = 0; k < sets.size(); ++k) {
+        cursors.push_back(sets[k].begin());
+        if (cursors[k] != sets[k].end()) {
+            heap.emplace(*cursors[k], k);
+        }
+    }
+
+    long long steps = 0;
+    while (!heap.empty()) {  // O(n log k)
+        ++steps;
+        auto [val, k] = heap.top();
+        heap.pop();
+
+        if (R.is_empty() || R.tail.prev->value != val) {
+            R.insert_node(&R.tail, val);
+        }
+        if (++cursors[k] != sets[k].end()) {
+            heap.emplace(*cursors[k], k);
+        }
+    }
+
+    NodeCounters::add(NodeCounters::union_steps, steps);
+    return R;
+}
+
+/*
+ * Return the intersection of all Sets in sets, or an empty Set if sets is empty
+ */
+Set Set::intersect_all(std::span<const Set> sets) {
+    Set R{};
+    if (sets.empty()) {
+        return R;
+    }
+
+    std::vector<const Set*> by_size;
+    for (const Set& S : sets) {
+        by_size.push_back(&S);
+    }
+    std::ranges::sort(by_size, {}, [](const Set* S) { return S->cardinality(); });  // smallest first
+
+    std::vector<const_iterator> cursors;
+    for (const Set* S : by_size) {
+        cursors.push_back(S->begin());
+    }
+
+    long long steps = 0;
+    for (int val : *by_size[0]) {
+        bool in_all = true;
+        for (size_t k = 1; k < by_size.size() && in_all; ++k) {
+            while (cursors[k] != by_size[k]->end() && *cursors[k] < val) {
+                ++steps;
+                ++cursors[k];
+            }
+            if (cursors[k] == by_size[k]->end()) {  // no larger values left in Set k
+                NodeCounters::add(NodeCounters::intersection_steps, steps);
+                return R;
+            }
+            in_all = (*cursors[k] == val);
+        }
+
+        if (in_all) {
+            R.insert_node(&R.tail, val);
+        }
+    }
+
+    NodeCounters::add(NodeCounters::intersection_steps, steps);
+    return R;
+}
 
 /* ******************************************** *
  * Private Member Functions -- Implementation   *
@@ -360,9 +770,29 @@ Set& Set::operator-=(const Set& S) {
 void Set::insert_node(Node* p, int val) {
     // IMPLEMENT before Lab2 HA
     // Lecture 4, slide 6
-    Node* newNode = new Node(val, p, p->prev);
+    Node* newNode;
+    if (free_nodes != nullptr) {  // reuse the memory of a removed Node of a block
+        Node* const slot = free_nodes;
+        free_nodes = *std::launder(reinterpret_cast<Node**>(slot));
+        newNode = Node::create_in_block(slot, val, p, p->prev);
+    } else {
+        newNode = new Node(val, p, p->prev);
+    }
     p->prev = p->prev->next = newNode;
     ++counter;
+    fingerprint += BloomFilter::hash(val);  // a sum does not depend on the order of the values
+
+    if (order_index) {
+        order_index->insert(val, newNode);
+    }
+
+    if (bloom) {
+        if (bloom->size() < bloom->capacity()) {
+            bloom->add(val);
+        } else {
+            rebuild_bloom_filter();  // the filter is full: double its size
+        }
+    }
 }
 
 /*
@@ -373,27 +803,148 @@ void Set::remove_node(Node* p) {
     // IMPLEMENT before Lab2 HA
     if (p == nullptr) { return; }
 
-    if (head == p) { head = p->next; }
+    if (order_index) {
+        order_index->erase(p->value);
+    }
 
     if (p->next != nullptr) { p->next->prev = p->prev; }
 
     if (p->prev != nullptr) { p->prev->next = p->next; }
 
-    delete p;
+    fingerprint -= BloomFilter::hash(p->value);
+    if (p->in_block) {  // the memory belongs to a block: keep it for a later insertion
+        p->~Node();
+        ::new (static_cast<void*>(p)) Node*{free_nodes};
+        free_nodes = p;
+    } else {
+        delete p;
+    }
     counter--;
 }
 
+/*
+ * Refill the order-statistic index with the Nodes of the Set: O(n)
+ */
+void Set::rebuild_order_index() {
+    order_index->reset();
+    for (const Node* ptr = head.next; ptr != &tail; ptr = ptr->next) {
+        order_index->add(ptr->value, ptr);
+    }
+    order_index->link();
+}
+
+/*
+ * Allocate memory for n Nodes in one block owned by the Set, nullptr if n is 0
+ */
+Set::Node* Set::allocate_nodes(size_t n) {
+    if (n == 0) {
+        return nullptr;
+    }
+    blocks.push_back(nullptr);  // may throw before the block is allocated
+    blocks.back() = Node::allocate_block(n);
+    return blocks.back();
+}
+
+/*
+ * Release the blocks of Nodes, once all their Nodes were removed
+ */
+void Set::release_blocks() {
+    for (Node* block : blocks) {
+        Node::deallocate_block(block);
+    }
+    blocks.clear();
+    free_nodes = nullptr;
+}
+
+/*
+ * Make the first and last Nodes point back to the dummy Nodes of *this, after a swap with S
+ */
+void Set::relink_dummies(const Set& S) {
+    if (head.next == &S.tail) {  // the list taken from S is empty
+        head.next = &tail;
+        tail.prev = &head;
+    } else {
+        head.next->prev = &head;
+        tail.prev->next = &tail;
+    }
+}
+
+/*
+ * Append the sorted unique ints in values after the last Node of the list
+ * All values must be larger than the current last value of the Set
+ */
+void Set::append_sorted(std::span<const int> values) {
+    Node* block = allocate_nodes(values.size());
+    Node* last = tail.prev;
+    for (int v : values) {
+        last = last->next = Node::create_in_block(block++, v, &tail, last);
+        ++counter;
+        fingerprint += BloomFilter::hash(v);
+        if (order_index) {
+            order_index->insert(v, last);
+        }
+    }
+    tail.prev = last;
+
+    if (bloom) {
+        if (bloom->size() + values.size() <= bloom->capacity()) {
+            for (int v : values) {
+                bloom->add(v);
+            }
+        } else {
+            rebuild_bloom_filter();
+        }
+    }
+}
+
+/*
+ * Refill the Bloom filter with the values of the Set, sized for twice as many values
+ */
+void Set::rebuild_bloom_filter() {
+    bloom->reset(2 * counter);
+    for (int v : *this) {
+        bloom->add(v);
+    }
+}
+
 /*
  * Write Set *this to stream os
+ * With the default formatting of os, the values are formatted with std::to_chars
+ * into a buffer reused by all writes of the thread, and written in chunks of write_chunk bytes
  */
 void Set::write_to_stream(std::ostream& os) const {
+    constexpr std::ptrdiff_t write_chunk = 1 << 16;
+    constexpr std::ptrdiff_t max_value_chars = 12;  // "-2147483648 "
+
+    const bool default_format = os.width() == 0 &&
+                                (os.flags() & (std::ios::basefield | std::ios::showpos)) == std::ios::dec &&
+                                os.getloc() == std::locale::classic();
+
     if (is_empty()) {
         os << "Set is empty!";
-    } else {
-        Set::Node* ptr{head->next};
+    } else if (default_format) {
+        thread_local std::vector<char> buffer;
+        buffer.resize(write_chunk + max_value_chars + 1);
+
+        char* const first = buffer.data();
+        char* out = first;
+        *out++ = '{';
+        *out++ = ' ';
+        for (const Node* ptr = head.next; ptr != &tail; ptr = ptr->next) {
+            if (out - first >= write_chunk) {
+                os.write(first, out - first);
+                out = first;
+            }
+            out = std::to_chars(out, out + max_value_chars, ptr->value).ptr;
+            *out++ = ' ';
+        }
+        *out++ = '}';
+        os.write(first, out - first);
+    } else {  // e.g. std::hex or a locale with digit grouping: let os format the values
+        Set::Node* ptr{head.next};
 
         os << "{ ";
-        while (ptr != tail) {
+        while (ptr != &tail) {
             os << ptr->value << " ";
             ptr = ptr->next;
         }
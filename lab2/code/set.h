@@ -2,19 +2,74 @@
 
 #include <iostream>
 #include <vector>
+#include <span>
+#include <iterator>
+#include <ranges>
 #include <compare>  // three-way comparison operator <=>
+#include <memory>
+#include <functional>  // std::hash
+#include <cstdint>
+
+#include "node.h"
+
+class BloomFilter;  // defined in bloom_filter.h
+class OrderIndex;   // defined in order_index.h
 
 /** Class to represent a Set of ints
  *
  * Set is implemented as a sorted doubly linked list
+ * The dummy head and tail Nodes are embedded in the Set object, so that
+ * creating, emptying and moving a Set allocate no memory
+ * The Nodes created together from sorted values or by a copy are allocated in one block,
+ * and the memory of their removed Nodes is reused by later insertions
  * Sets should not contain repetitions, i.e.
  * two ints with the same value cannot belong to a Set
  *
  * All Set operations must have a linear time complexity, in the worst case
  */
 class Set {
+    using Node = SetNode;  // defined in node.h
 
 public:
+    /*
+     * Bidirectional iterator over the values of a Set, in increasing order
+     * The values cannot be modified through an iterator
+     * An iterator is invalidated only when the Node it refers to is removed
+     */
+    class const_iterator {
+    public:
+        using iterator_concept = std::bidirectional_iterator_tag;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const_iterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        const_iterator& operator--();
+        const_iterator operator--(int);
+
+        bool operator==(const const_iterator& it) const = default;
+
+    private:
+        friend class Set;
+
+        explicit const_iterator(const Node* p) : ptr{p} {
+        }
+
+        const Node* ptr{nullptr};  // Node storing the value, or the dummy tail Node for end()
+    };
+
+    using iterator = const_iterator;
+    using value_type = int;
+    using size_type = size_t;
+
     /*
      *  Default constructor :create an empty Set
      */
@@ -31,6 +86,13 @@ public:
      */
     explicit Set(const std::vector<int>& list_of_values);
 
+    /*
+     * Create a Set from a vector of ints in any order, possibly with repetitions
+     * The values are sorted and the repetitions removed in parallel,
+     * then the list is linked in a single pass
+     */
+    static Set from_unsorted(std::vector<int> values);
+
     /*
      * Copy constructor: create a new Set as a copy of Set S
      * \param S Set to copied
@@ -38,6 +100,12 @@ public:
      */
     Set(const Set& S);
 
+    /*
+     * Move constructor: take the values of S in O(1), S becomes empty
+     * No memory is allocated
+     */
+    Set(Set&& S) noexcept;
+
     /*
      * Transform the Set into an empty set
      * Remove all nodes from the list, except the dummy nodes
@@ -52,10 +120,15 @@ public:
     /*
      * Assignment operator: assign new contents to the *this Set, replacing its current content
      * \param S Set to be copied into Set *this
-     * Call by valued is used
+     * Call by valued is used: S is moved from an rvalue, in O(1)
      */
     Set& operator=(Set S);
 
+    /*
+     * Exchange the values of *this and S: O(1)
+     */
+    void swap(Set& S) noexcept;
+
     /*
      * Test whether val belongs to the Set
      * Return true if val belongs to the set, otherwise false
@@ -63,6 +136,113 @@ public:
      */
     bool is_member(int val) const;
 
+    /*
+     * Attach a blocked Bloom filter to the Set, so that is_member answers most misses
+     * with one cache-line probe instead of a traversal of the list
+     * \param bits_per_value memory used by the filter per value of the Set:
+     * about 1% false positives with 10 bits, 0.1% with 16 bits
+     * The filter is updated by every insertion, and rebuilt after *= and -=
+     */
+    void enable_bloom_filter(double bits_per_value = 10.0);
+
+    /*
+     * Remove the Bloom filter of the Set, if any
+     */
+    void disable_bloom_filter();
+
+    bool has_bloom_filter() const {
+        return bloom != nullptr;
+    }
+
+    /*
+     * Return the number of bytes used by the Bloom filter, 0 if the Set has no filter
+     */
+    size_t bloom_filter_bytes() const;
+
+    /*
+     * Return the expected false-positive rate of the Bloom filter, 1 if the Set has no filter
+     */
+    double bloom_filter_false_positive_rate() const;
+
+    /*
+     * Return an iterator to the smallest value of the Set, or end() if the Set is empty
+     */
+    const_iterator begin() const;
+
+    /*
+     * Return the past-the-end iterator
+     */
+    const_iterator end() const;
+
+    /*
+     * Attach an order-statistic index to the Set (a treap of the Nodes with subtree sizes),
+     * so that lower_bound, rank, select, count_range and find run in O(log n)
+     * Every insertion and removal updates the index in O(log n),
+     * and +=, *= and -= rebuild it after the merge in O(n)
+     * Without the index, these queries walk the list in O(n)
+     * The queries never modify the Set, so they can run concurrently on the same Set
+     */
+    void enable_order_index();
+
+    /*
+     * Remove the order-statistic index of the Set, if any
+     */
+    void disable_order_index();
+
+    bool has_order_index() const {
+        return order_index != nullptr;
+    }
+
+    /*
+     * Return an iterator to the smallest value of the Set not less than val, or end() if none
+     */
+    const_iterator lower_bound(int val) const;
+
+    /*
+     * Return the number of values of the Set smaller than val
+     */
+    size_t rank(int val) const;
+
+    /*
+     * Return an iterator to the k-th smallest value of the Set (k = 0 for the smallest),
+     * or end() if k >= cardinality()
+     */
+    const_iterator select(size_t k) const;
+
+    /*
+     * Return the number of values of the Set in the range [a, b], 0 if a > b
+     */
+    size_t count_range(int a, int b) const;
+
+    /*
+     * Return an iterator to val, or end() if val does not belong to the Set
+     */
+    const_iterator find(int val) const;
+
+    /*
+     * Insert val, return false if it already belonged to the Set
+     * No temporary Set is created: a single new Node is linked into the list
+     */
+    bool insert(int val);
+
+    /*
+     * Insert val using hint as a starting position, return an iterator to val
+     * The list is walked from hint, forwards or backwards, to the position of val:
+     * O(1) if val is inserted right before hint, e.g. insert(end(), val) for increasing values
+     */
+    const_iterator insert(const_iterator hint, int val);
+
+    /*
+     * Remove val, return false if it did not belong to the Set
+     */
+    bool erase(int val);
+
+    /*
+     * Remove the value at pos, which must be a valid dereferenceable iterator: O(1)
+     * Return an iterator to the value following the removed value
+     */
+    const_iterator erase(const_iterator pos);
+
     /*
      * Test whether the Set is empty
      * Return true if the set is empty, otherwise false
@@ -81,6 +261,31 @@ public:
         return counter;
     }
 
+    /*
+     * Count the number of values in the intersection of *this and S
+     * Computed with a single read-only merge, the intersection is not created
+     */
+    size_t intersection_size(const Set& S) const;
+
+    /*
+     * Count the number of values in the union of *this and S, without creating the union
+     */
+    size_t union_size(const Set& S) const {
+        return counter + S.counter - intersection_size(S);
+    }
+
+    /*
+     * Count the number of values in the Set difference *this - S, without creating the difference
+     */
+    size_t difference_size(const Set& S) const {
+        return counter - intersection_size(S);
+    }
+
+    /*
+     * Return the Jaccard similarity |*this * S| / |*this + S|, 1 if both Sets are empty
+     */
+    double jaccard(const Set& S) const;
+
     /*
      * Test whether Set *this and S represent the same set
      * Return true, if *this has same elemnts as set S
@@ -88,6 +293,28 @@ public:
      */
     bool operator==(const Set& S) const;
 
+    /*
+     * Return a hash of the values of the Set, kept up to date by every insertion and removal: O(1)
+     * Equal Sets have equal hashes, so Sets with different hashes are rejected by == in O(1)
+     */
+    size_t hash() const {
+        return static_cast<size_t>(fingerprint);
+    }
+
+    /*
+     * Test whether every value of *this belongs to Set S
+     * Cardinalities and smallest/largest values are compared first, then a single pass
+     * stops at the first value of *this missing in S, or when S has too few values left
+     */
+    bool is_subset_of(const Set& S) const;
+
+    /*
+     * Test whether every value of Set S belongs to *this
+     */
+    bool is_superset_of(const Set& S) const {
+        return S.is_subset_of(*this);
+    }
+
     /*
      * Three-way comparison operator: to test whether *this == S, *this < S, *this > S
      * Return std::partial_ordering::equivalent, if *this == S
@@ -97,6 +324,15 @@ public:
      */
     std::partial_ordering operator<=>(const Set& S) const;
 
+    /*
+     * Compare *this with the singleton {val}, without creating it
+     * *this == val is true if *this is {val}: O(1)
+     * *this <=> val is less if *this is empty, and greater if val is one of several values of *this
+     * Used by mixed expressions such as 3 < S and S == 10
+     */
+    bool operator==(int val) const;
+    std::partial_ordering operator<=>(int val) const;
+
     /*
      * Modify Set *this such that it becomes the union of *this with Set S
      * Set *this is modified and then returned
@@ -115,19 +351,66 @@ public:
      */
     Set& operator-=(const Set& S);
 
+    /*
+     * Union, intersection and difference with the singleton {val}, without creating it
+     * += and -= insert and erase one Node, *= removes all values but val
+     */
+    Set& operator+=(int val);
+    Set& operator*=(int val);
+    Set& operator-=(int val);
+
+    /*
+     * Return the union of all Sets in sets, without intermediate Sets
+     * k-way merge with a min-heap holding the smallest remaining value of each Set: O(n log k)
+     */
+    static Set union_all(std::span<const Set> sets);
+
+    /*
+     * Return the intersection of all Sets in sets, or an empty Set if sets is empty
+     * The values of the smallest Set are looked up in the other Sets with forward cursors,
+     * and the merge stops as soon as any Set is exhausted
+     */
+    static Set intersect_all(std::span<const Set> sets);
+
     /*
      * Return number of existing nodes
      * Used solely for debug purposes
      */
     static int get_count_nodes();
 
-private:
-    class Node;  // nested class defined in node.h
+    /*
+     * Statistics about the Nodes of all Sets and the merges executed, aggregated over all threads
+     */
+    struct Statistics {
+        long long live_nodes;          // number of existing Nodes
+        long long allocations;         // number of Nodes allocated so far
+        long long bytes;               // number of bytes allocated for Nodes so far
+        long long peak_live_nodes;     // high-water mark of live_nodes (upper bound with several threads)
+        long long union_steps;         // merge steps executed by operator+=
+        long long intersection_steps;  // merge steps executed by operator*=
+        long long difference_steps;    // merge steps executed by operator-=
+    };
 
-    Node* head;      // pointer to the dummy header Node
-    Node* tail;      // pointer to the dummy tail Node
+    /*
+     * Return the current statistics
+     * Used solely for debug and profiling purposes
+     */
+    static Statistics get_statistics();
+
+private:
+    Node head;       // dummy header Node, embedded in the Set
+    Node tail;       // dummy tail Node, embedded in the Set
     size_t counter;  // number of values in the Set
 
+    std::uint64_t fingerprint{0};  // sum of the hashes of the values, modulo 2^64
+
+    std::unique_ptr<BloomFilter> bloom;  // optional filter of the values, may have false positives
+
+    std::vector<Node*> blocks;  // blocks of Nodes allocated at once, released when the Set is emptied
+    Node* free_nodes{nullptr};  // memory of the removed Nodes of the blocks, linked through its first bytes
+
+    std::unique_ptr<OrderIndex> order_index;  // optional order-statistic index of the Nodes
+
     /* ************************** *
      * Private Member Functions    *
      * **************************  */
@@ -145,6 +428,41 @@ private:
      */
     void remove_node(Node* p);
 
+    /*
+     * Append the sorted unique ints in values after the last Node of the list
+     * All values must be larger than the current last value of the Set
+     * The new Nodes are allocated in one block
+     */
+    void append_sorted(std::span<const int> values);
+
+    /*
+     * Allocate memory for n Nodes in one block owned by the Set, nullptr if n is 0
+     */
+    Node* allocate_nodes(size_t n);
+
+    /*
+     * Release the blocks of Nodes, once all their Nodes were removed
+     */
+    void release_blocks();
+
+    /*
+     * Make the first and last Nodes point back to the dummy Nodes of *this,
+     * after the links to them were swapped with Set S
+     */
+    void relink_dummies(const Set& S);
+
+    /*
+     * Refill the order-statistic index with the Nodes of the Set: O(n)
+     * Used after merges, which would otherwise update it once per inserted or removed Node
+     */
+    void rebuild_order_index();
+
+    /*
+     * Refill the Bloom filter with the values of the Set, sized for twice as many values
+     * Used after removals, and when the filter is full
+     */
+    void rebuild_bloom_filter();
+
     /*
      * Write Set *this to stream os
      */
@@ -189,4 +507,86 @@ private:
     friend Set operator-(Set S1, const Set& S2) {
         return (S1 -= S2);
     }
-};
\ No newline at end of file
+
+    /*
+     * Overloaded operators+, * and - with an int operand: no Set is created for the int
+     */
+    friend Set operator+(Set S, int val) {
+        return (S += val);
+    }
+
+    friend Set operator+(int val, Set S) {
+        return (S += val);
+    }
+
+    friend Set operator*(Set S, int val) {
+        return (S *= val);
+    }
+
+    friend Set operator*(int val, Set S) {
+        return (S *= val);
+    }
+
+    friend Set operator-(Set S, int val) {
+        return (S -= val);
+    }
+
+    friend Set operator-(int val, const Set& S) {
+        return S.is_member(val) ? Set{} : Set{val};
+    }
+};
+
+/* ********************************************** *
+ * Inline member functions of Set::const_iterator  *
+ * ********************************************** */
+
+inline Set::const_iterator::reference Set::const_iterator::operator*() const {
+    return ptr->value;
+}
+
+inline Set::const_iterator::pointer Set::const_iterator::operator->() const {
+    return &ptr->value;
+}
+
+inline Set::const_iterator& Set::const_iterator::operator++() {
+    ptr = ptr->next;
+    return *this;
+}
+
+inline Set::const_iterator Set::const_iterator::operator++(int) {
+    const_iterator it{*this};
+    ptr = ptr->next;
+    return it;
+}
+
+inline Set::const_iterator& Set::const_iterator::operator--() {
+    ptr = ptr->prev;
+    return *this;
+}
+
+inline Set::const_iterator Set::const_iterator::operator--(int) {
+    const_iterator it{*this};
+    ptr = ptr->prev;
+    return it;
+}
+
+inline Set::const_iterator Set::begin() const {
+    return const_iterator{head.next};
+}
+
+inline Set::const_iterator Set::end() const {
+    return const_iterator{&tail};
+}
+
+/*
+ * Sets can be used as keys of hash containers, the hash is not recomputed
+ */
+template <>
+struct std::hash<Set> {
+    size_t operator()(const Set& S) const noexcept {
+        return S.hash();
+    }
+};
+
+static_assert(std::bidirectional_iterator<Set::const_iterator>);
+static_assert(std::ranges::bidirectional_range<Set>);
@@ -0,0 +1,514 @@
+#include "set_io.h"
+#include "set_merge.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::endian::native == std::endian::little, "the binary Set format is little endian");
+
+namespace {
+/*
+ * Header of the binary format, the payload starts right after it
+ */
+struct Header {
+    char magic[4];
+    std::uint32_t encoding;
+    std::uint64_t count;
+    std::int32_t min;
+    std::int32_t max;
+    std::uint64_t payload_bytes;
+};
+static_assert(sizeof(Header) == 32);
+
+constexpr char magic[4] = {'S', 'E', 'T', '1'};
+
+/*
+ * Number of bytes of the LEB128 varint encoding of x
+ */
+size_t varint_size(std::uint32_t x) {
+    return static_cast<size_t>(std::bit_width(x | 1u) + 6) / 7;
+}
+
+/*
+ * Gap between consecutive values prev < v, minus one
+ */
+std::uint32_t gap(int prev, int v) {
+    return static_cast<std::uint32_t>(v) - static_cast<std::uint32_t>(prev) - 1u;
+}
+
+/*
+ * Output buffer flushed to a stream in large chunks
+ */
+class Buffer {
+public:
+    explicit Buffer(std::ostream& os) : out{os} {
+    }
+
+    ~Buffer() {
+        flush();
+    }
+
+    void put(const void* src, size_t n) {
+        if (used + n > bytes.size()) {
+            flush();
+        }
+        std::memcpy(bytes.data() + used, src, n);
+        used += n;
+    }
+
+    void put_varint(std::uint32_t x) {
+        std::byte b[5];
+        size_t n = 0;
+        while (x >= 0x80) {
+            b[n++] = static_cast<std::byte>((x & 0x7F) | 0x80);
+            x >>= 7;
+        }
+        b[n++] = static_cast<std::byte>(x);
+        put(b, n);
+    }
+
+    void flush() {
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+
+private:
+    std::ostream& out;
+    std::array<std::byte, 1 << 16> bytes;
+    size_t used{0};
+};
+
+/*
+ * Decode the varint starting at p, advance p past it
+ * Throw std::runtime_error if the varint does not end before end
+ */
+std::uint32_t read_varint(const std::byte*& p, const std::byte* end) {
+    std::uint32_t x = 0;
+    for (int shift = 0; p != end && shift < 35; shift += 7) {
+        const auto b = static_cast<std::uint32_t>(*p++);
+        x |= (b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            return x;
+        }
+    }
+    throw std::runtime_error{"Malformed Set file: truncated varint"};
+}
+
+/*
+ * Return the 64 bits of bitmap starting at bit offset, bits past the end of bitmap are zeros
+ */
+std::uint64_t bits_at(std::span<const std::byte> bitmap, std::uint64_t offset) {
+    const std::uint64_t n_words = bitmap.size() / 8;
+    const std::uint64_t w = offset / 64;
+    const std::uint64_t shift = offset % 64;
+
+    std::uint64_t low = 0, high = 0;
+    if (w < n_words) {
+        std::memcpy(&low, bitmap.data() + 8 * w, sizeof low);
+    }
+    if (shift == 0) {
+        return low;
+    }
+    if (w + 1 < n_words) {
+        std::memcpy(&high, bitmap.data() + 8 * (w + 1), sizeof high);
+    }
+    return (low >> shift) | (high << (64 - shift));
+}
+}  // namespace
+
+/*****************************************************
+ * Writer                                             *
+ ******************************************************/
+
+/*
+ * Write Set S in binary format to stream os
+ */
+void write_binary(std::ostream& os, const Set& S, SetEncoding encoding) {
+    Header h{};
+    std::memcpy(h.magic, magic, sizeof magic);
+    h.count = S.cardinality();
+    h.min = S.is_empty() ? 0 : *S.begin();
+    h.max = S.is_empty() ? -1 : *std::prev(S.end());
+
+    const std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(h.max) - h.min + 1);
+    const std::uint64_t bitmap_bytes = (range + 63) / 64 * 8;
+    const std::uint64_t array_bytes = 4 * h.count;
+
+    if (encoding == SetEncoding::automatic) {
+        std::uint64_t varint_bytes = 0;
+        for (auto it = S.begin(); it != S.end() && varint_bytes < std::min(bitmap_bytes, array_bytes); ++it) {
+            varint_bytes += (it == S.begin()) ? 0 : varint_size(gap(*std::prev(it), *it));
+        }
+
+        if (varint_bytes < std::min(bitmap_bytes, array_bytes)) {
+            encoding = SetEncoding::varint_delta;
+        } else {
+            encoding = (bitmap_bytes < array_bytes) ? SetEncoding::bitmap : SetEncoding::int32_array;
+        }
+    }
+    h.encoding = static_cast<std::uint32_t>(encoding);
+
+    switch (encoding) {
+        case SetEncoding::varint_delta:
+            h.payload_bytes = 0;
+            for (auto it = S.begin(); it != S.end(); ++it) {
+                h.payload_bytes += (it == S.begin()) ? 0 : varint_size(gap(*std::prev(it), *it));
+            }
+            break;
+        case SetEncoding::bitmap:
+            h.payload_bytes = bitmap_bytes;
+            break;
+        case SetEncoding::int32_array:
+            h.payload_bytes = array_bytes;
+            break;
+        default:
+            throw std::invalid_argument{"Unknown Set encoding"};
+    }
+
+    Buffer buffer{os};
+    buffer.put(&h, sizeof h);
+
+    if (encoding == SetEncoding::varint_delta) {
+        int prev = h.min;
+        for (int v : S) {
+            if (v != h.min) {
+                buffer.put_varint(gap(prev, v));
+            }
+            prev = v;
+        }
+    } else if (encoding == SetEncoding::bitmap) {
+        std::uint64_t word = 0;
+        std::uint64_t word_index = 0;
+        for (int v : S) {
+            const std::uint64_t offset = static_cast<std::uint32_t>(v) - static_cast<std::uint32_t>(h.min);
+            while (word_index < offset / 64) {
+                buffer.put(&word, sizeof word);
+                word = 0;
+                ++word_index;
+            }
+            word |= std::uint64_t{1} << (offset % 64);
+        }
+        for (; word_index < bitmap_bytes / 8; ++word_index) {
+            buffer.put(&word, sizeof word);
+            word = 0;
+        }
+    } else {
+        for (int v : S) {
+            const std::int32_t x = v;
+            buffer.put(&x, sizeof x);
+        }
+    }
+}
+
+/*****************************************************
+ * SetView                                            *
+ ******************************************************/
+
+/*
+ * Create a view of a Set in binary format stored in bytes
+ */
+SetView::SetView(std::span<const std::byte> bytes) {
+    Header h;
+    if (bytes.size() < sizeof h) {
+        throw std::runtime_error{"Malformed Set file: too short"};
+    }
+    if (reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(std::uint64_t) != 0) {
+        throw std::runtime_error{"Set view: misaligned bytes"};
+    }
+
+    std::memcpy(&h, bytes.data(), sizeof h);
+    if (std::memcmp(h.magic, magic, sizeof magic) != 0) {
+        throw std::runtime_error{"Malformed Set file: bad magic number"};
+    }
+    if (h.payload_bytes > bytes.size() - sizeof h) {
+        throw std::runtime_error{"Malformed Set file: truncated payload"};
+    }
+
+    enc = static_cast<SetEncoding>(h.encoding);
+    count = h.count;
+    min = h.min;
+    max = h.max;
+    payload = bytes.subspan(sizeof h, static_cast<size_t>(h.payload_bytes));
+
+    if (count == 0 && !payload.empty()) {
+        throw std::runtime_error{"Malformed Set file: payload of an empty Set"};
+    }
+    if (count > 0 && min > max) {
+        throw std::runtime_error{"Malformed Set file: min > max"};
+    }
+
+    // Sizes are compared by division, so that a huge count cannot overflow
+    const std::uint64_t range = count == 0 ? 0 : static_cast<std::uint64_t>(std::int64_t{max} - min + 1);
+    switch (enc) {
+        case SetEncoding::varint_delta:
+            if (count > 0 && count - 1 > payload.size()) {  // every gap takes at least one byte
+                throw std::runtime_error{"Malformed Set file: too few varints"};
+            }
+            break;
+        case SetEncoding::bitmap:
+            if (count > range) {
+                throw std::runtime_error{"Malformed Set file: more values than the range of the bitmap"};
+            }
+            if (payload.size() % 8 != 0 || payload.size() / 8 != (range + 63) / 64) {
+                throw std::runtime_error{"Malformed Set file: wrong bitmap size"};
+            }
+            break;
+        case SetEncoding::int32_array:
+            if (payload.size() % 4 != 0 || count != payload.size() / 4) {
+                throw std::runtime_error{"Malformed Set file: wrong array size"};
+            }
+            break;
+        default:
+            throw std::runtime_error{"Malformed Set file: unknown encoding"};
+    }
+}
+
+/*
+ * Test whether val belongs to the Set
+ */
+bool SetView::is_member(int val) const {
+    if (count == 0 || val < min || val > max) {
+        return false;
+    }
+
+    switch (enc) {
+        case SetEncoding::bitmap: {
+            const std::uint64_t offset = static_cast<std::uint32_t>(val) - static_cast<std::uint32_t>(min);
+            std::uint64_t word;
+            std::memcpy(&word, payload.data() + offset / 64 * 8, sizeof word);
+            return ((word >> (offset % 64)) & 1) != 0;
+        }
+        case SetEncoding::int32_array: {
+            const auto* first = reinterpret_cast<const std::int32_t*>(payload.data());
+            return std::binary_search(first, first + count, val);
+        }
+        default: {
+            auto it = std::find_if(begin(), end(), [val](int v) { return v >= val; });
+            return it != end() && *it == val;
+        }
+    }
+}
+
+SetView::const_iterator SetView::begin() const {
+    const_iterator it{};
+    it.view = this;
+    it.remaining = count;
+    it.pos = payload.data();
+    if (count == 0) {
+        return it;
+    }
+
+    if (enc == SetEncoding::bitmap) {
+        std::memcpy(&it.word, it.pos, sizeof it.word);
+        it.remaining = count + 1;  // ++ finds the first set bit
+        ++it;
+    } else if (enc == SetEncoding::int32_array) {
+        std::memcpy(&it.value, it.pos, sizeof it.value);
+    } else {
+        it.value = min;
+    }
+    return it;
+}
+
+SetView::const_iterator SetView::end() const {
+    const_iterator it{};
+    it.view = this;
+    return it;
+}
+
+SetView::const_iterator& SetView::const_iterator::operator++() {
+    if (--remaining == 0) {
+        return *this;
+    }
+
+    switch (view->enc) {
+        case SetEncoding::bitmap:
+            while (word == 0) {
+                if (pos + 2 * sizeof word > view->payload.data() + view->payload.size()) {
+                    throw std::runtime_error{"Malformed Set file: too few bits in bitmap"};
+                }
+                pos += sizeof word;
+                ++word_index;
+                std::memcpy(&word, pos, sizeof word);
+            }
+            value = static_cast<int>(static_cast<std::uint32_t>(view->min) +
+                                     static_cast<std::uint32_t>(word_index * 64 + std::countr_zero(word)));
+            word &= word - 1;  // clear the lowest set bit
+            break;
+        case SetEncoding::int32_array:
+            pos += sizeof(std::int32_t);
+            std::memcpy(&value, pos, sizeof value);
+            break;
+        default: {
+            const std::byte* payload_end = view->payload.data() + view->payload.size();
+            value = static_cast<int>(static_cast<std::uint32_t>(value) + read_varint(pos, payload_end) + 1u);
+        }
+    }
+    return *this;
+}
+
+/*
+ * Count the number of values in the intersection of the views
+ */
+size_t SetView::intersection_size(const SetView& V) const {
+    const std::int64_t lo = std::max(min, V.min);
+    const std::int64_t hi = std::min(max, V.max);
+    if (is_empty() || V.is_empty() || lo > hi) {
+        return 0;
+    }
+
+    size_t common = 0;
+    if (enc == SetEncoding::bitmap && V.enc == SetEncoding::bitmap) {
+        // Bits past the largest value of either bitmap are zero, so no mask is needed at hi
+        for (std::int64_t x = lo; x <= hi; x += 64) {
+            const std::uint64_t a = bits_at(payload, static_cast<std::uint64_t>(x - min));
+            const std::uint64_t b = bits_at(V.payload, static_cast<std::uint64_t>(x - V.min));
+            common += static_cast<size_t>(std::popcount(a & b));
+        }
+    } else if (enc == SetEncoding::int32_array && V.enc == SetEncoding::int32_array) {
+        const auto* a = reinterpret_cast<const std::int32_t*>(payload.data());
+        const auto* b = reinterpret_cast<const std::int32_t*>(V.payload.data());
+        const auto* a_end = a + count;
+        const auto* b_end = b + V.count;
+        while (a != a_end && b != b_end) {
+            const std::int32_t x = *a, y = *b;
+            common += (x == y);
+            a += (x <= y);
+            b += (y <= x);
+        }
+    } else {
+        common = count_common(*this, V);
+    }
+    return common;
+}
+
+/*
+ * Return the Jaccard similarity of the views, 1 if both are empty
+ */
+double SetView::jaccard(const SetView& V) const {
+    const size_t common = intersection_size(V);
+    const size_t all = cardinality() + V.cardinality() - common;
+    return (all == 0) ? 1.0 : static_cast<double>(common) / static_cast<double>(all);
+}
+
+/*
+ * Decode the view into a Set
+ */
+Set SetView::to_set() const {
+    return Set{std::vector<int>(begin(), end())};
+}
+
+/*
+ * Set operations between a view and a Set
+ */
+Set operator+(const SetView& V, const Set& S) {
+    return Set{merge_sorted(V, S, keep_union)};
+}
+
+Set operator+(const Set& S, const SetView& V) {
+    return V + S;
+}
+
+Set operator*(const SetView& V, const Set& S) {
+    return Set{merge_sorted(V, S, keep_intersection)};
+}
+
+Set operator*(const Set& S, const SetView& V) {
+    return V * S;
+}
+
+Set operator-(const SetView& V, const Set& S) {
+    return Set{merge_sorted(V, S, keep_difference)};
+}
+
+Set operator-(const Set& S, const SetView& V) {
+    return Set{merge_sorted(S, V, keep_difference)};
+}
+
+/*****************************************************
+ * MappedSet                                          *
+ ******************************************************/
+
+/*
+ * Map the file at path
+ */
+MappedSet::MappedSet(const std::filesystem::path& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error{"Unable to open Set file: " + path.string()};
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file, &file_size);
+    size = static_cast<size_t>(file_size.QuadPart);
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        throw std::runtime_error{"Unable to map Set file: " + path.string()};
+    }
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        CloseHandle(mapping);
+        throw std::runtime_error{"Unable to map Set file: " + path.string()};
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error{"Unable to open Set file: " + path.string()};
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error{"Malformed Set file: " + path.string()};
+    }
+    size = static_cast<size_t>(st.st_size);
+    data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        data = nullptr;
+        throw std::runtime_error{"Unable to map Set file: " + path.string()};
+    }
+#endif
+
+    try {
+        set_view.emplace(std::span<const std::byte>{static_cast<const std::byte*>(data), size});
+    } catch (...) {
+        unmap();
+        throw;
+    }
+}
+
+MappedSet::~MappedSet() {
+    unmap();
+}
+
+void MappedSet::unmap() {
+#ifdef _WIN32
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+        CloseHandle(mapping);
+    }
+#else
+    if (data != nullptr) {
+        ::munmap(data, size);
+    }
+#endif
+    data = nullptr;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <span>
+
+#include "set.h"
+
+/** Binary format of a Set
+ *
+ * A 32-byte header followed by the payload, all integers little endian
+ *   magic "SET1", encoding, number of values, smallest value, largest value, payload size
+ *
+ * Encodings of the payload
+ *   varint_delta: gaps between consecutive values minus one, as LEB128 varints (sparse Sets)
+ *   bitmap:       one bit per int in [min, max], in 64-bit words (dense Sets)
+ *   int32_array:  the sorted values (Sets that are neither sparse nor dense)
+ */
+enum class SetEncoding : std::uint32_t { automatic = 0, varint_delta = 1, bitmap = 2, int32_array = 3 };
+
+/*
+ * Write Set S in binary format to stream os
+ * The payload is encoded while it is written, through a fixed-size buffer
+ * automatic selects the encoding that produces the smallest payload
+ */
+void write_binary(std::ostream& os, const Set& S, SetEncoding encoding = SetEncoding::automatic);
+
+/** Class SetView
+ *
+ * Read-only Set stored in binary format, in memory that the view does not own (e.g. a mapped file)
+ * The values are decoded on the fly: nothing is copied when the view is created,
+ * and is_member, iteration and the set operations with a Set work directly on the bytes
+ */
+class SetView {
+public:
+    /*
+     * Forward iterator decoding the values of the view, in increasing order
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return value;
+        }
+
+        const_iterator& operator++();
+        const_iterator operator++(int) {
+            const_iterator it{*this};
+            ++*this;
+            return it;
+        }
+
+        // Two iterators of the same view are equal when the same number of values remain
+        bool operator==(const const_iterator& it) const {
+            return remaining == it.remaining;
+        }
+
+    private:
+        friend class SetView;
+
+        const SetView* view{nullptr};
+        const std::byte* pos{nullptr};  // next byte (varint, int32_array) or word (bitmap) to decode
+        std::uint64_t word{0};          // bits of the current bitmap word not visited yet
+        std::uint64_t word_index{0};    // index of the current bitmap word
+        std::uint64_t remaining{0};     // number of values not visited yet, including value
+        int value{0};
+    };
+
+    /*
+     * Create a view of a Set in binary format stored in bytes
+     * bytes must be 8-byte aligned and outlive the view
+     * Throw std::runtime_error if bytes does not hold a valid header and payload
+     */
+    explicit SetView(std::span<const std::byte> bytes);
+
+    SetEncoding encoding() const {
+        return enc;
+    }
+
+    size_t cardinality() const {
+        return static_cast<size_t>(count);
+    }
+
+    bool is_empty() const {
+        return count == 0;
+    }
+
+    /*
+     * Test whether val belongs to the Set
+     * O(1) for bitmaps, O(log n) for int32 arrays, and a sequential decode for varints
+     */
+    bool is_member(int val) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Count the number of values in the intersection of the views, without decoding them
+     * Two bitmaps are intersected 64 values at a time with popcount, two int32 arrays
+     * with a branchless merge, and any other pair with a merge of the decoded values
+     */
+    size_t intersection_size(const SetView& V) const;
+
+    size_t union_size(const SetView& V) const {
+        return cardinality() + V.cardinality() - intersection_size(V);
+    }
+
+    size_t difference_size(const SetView& V) const {
+        return cardinality() - intersection_size(V);
+    }
+
+    /*
+     * Return the Jaccard similarity of the views, 1 if both are empty
+     */
+    double jaccard(const SetView& V) const;
+
+    /*
+     * Decode the view into a Set
+     */
+    Set to_set() const;
+
+private:
+    SetEncoding enc;
+    std::uint64_t count;
+    int min;
+    int max;
+    std::span<const std::byte> payload;
+};
+
+/*
+ * Set operations between a view and a Set, computed with a single merge over the encoded bytes
+ */
+Set operator+(const SetView& V, const Set& S);
+Set operator+(const Set& S, const SetView& V);
+Set operator*(const SetView& V, const Set& S);
+Set operator*(const Set& S, const SetView& V);
+Set operator-(const SetView& V, const Set& S);
+Set operator-(const Set& S, const SetView& V);
+
+/** Class MappedSet
+ *
+ * A file in binary Set format mapped read-only into memory, and a SetView of it
+ * Opening is O(1) regardless of the size of the file: pages are read when first accessed
+ */
+class MappedSet {
+public:
+    /*
+     * Map the file at path
+     * Throw std::runtime_error if the file cannot be mapped or is not a valid Set file
+     */
+    explicit MappedSet(const std::filesystem::path& path);
+
+    ~MappedSet();
+
+    MappedSet(const MappedSet&) = delete;
+    MappedSet& operator=(const MappedSet&) = delete;
+
+    const SetView& view() const {
+        return *set_view;
+    }
+
+private:
+    void* data{nullptr};  // start of the mapping
+    size_t size{0};       // size of the mapping in bytes
+#ifdef _WIN32
+    void* mapping{nullptr};  // handle of the file mapping object
+#endif
+    std::optional<SetView> set_view;
+
+    void unmap();
+};
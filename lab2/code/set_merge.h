@@ -0,0 +1,78 @@
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+/*
+ * Merge the sorted ranges of unique ints A and B in a single pass
+ * keep(in_a, in_b) decides whether a value present in A and/or in B belongs to the result
+ * Return the values kept, in increasing order
+ *
+ * Used by the Set representations that only provide forward iterators (decoders)
+ */
+template <typename RangeA, typename RangeB, typename Keep>
+std::vector<int> merge_sorted(const RangeA& A, const RangeB& B, Keep keep) {
+    std::vector<int> result;
+    auto a = std::begin(A), a_end = std::end(A);
+    auto b = std::begin(B), b_end = std::end(B);
+
+    while (a != a_end && b != b_end) {
+        if (*a < *b) {
+            if (keep(true, false)) result.push_back(*a);
+            ++a;
+        } else if (*b < *a) {
+            if (keep(false, true)) result.push_back(*b);
+            ++b;
+        } else {
+            if (keep(true, true)) result.push_back(*a);
+            ++a;
+            ++b;
+        }
+    }
+    for (; a != a_end && keep(true, false); ++a) {
+        result.push_back(*a);
+    }
+    for (; b != b_end && keep(false, true); ++b) {
+        result.push_back(*b);
+    }
+
+    return result;
+}
+
+/*
+ * Count the values present in both sorted ranges of unique ints A and B, in a single pass
+ */
+template <typename RangeA, typename RangeB>
+size_t count_common(const RangeA& A, const RangeB& B) {
+    size_t count = 0;
+    auto a = std::begin(A), a_end = std::end(A);
+    auto b = std::begin(B), b_end = std::end(B);
+
+    while (a != a_end && b != b_end) {
+        if (*a < *b) {
+            ++a;
+        } else if (*b < *a) {
+            ++b;
+        } else {
+            ++count;
+            ++a;
+            ++b;
+        }
+    }
+    return count;
+}
+
+/*
+ * keep functions of merge_sorted for union, intersection and difference
+ */
+inline bool keep_union(bool in_a, bool in_b) {
+    return in_a || in_b;
+}
+
+inline bool keep_intersection(bool in_a, bool in_b) {
+    return in_a && in_b;
+}
+
+inline bool keep_difference(bool in_a, bool in_b) {
+    return in_a && !in_b;
+}
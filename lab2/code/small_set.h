@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** Class template to represent a Set of values of type T, ordered by Compare
+ *
+ * The values are stored sorted and without repetitions in a contiguous array:
+ * up to N values are stored inline, in the SmallSet object itself, so small Sets
+ * allocate no memory at all
+ * A SmallSet that outgrows the inline buffer moves its values to the heap (a std::vector),
+ * and moves them back to the inline buffer only when it shrinks to N / 2 values or less,
+ * so that alternating insertions and removals around N values do not allocate every time
+ *
+ * T must be default constructible and copyable
+ * Two values x and y are equivalent when !comp(x, y) && !comp(y, x)
+ * Set operations have a linear time complexity; insert and erase are linear in the worst case
+ */
+template <typename T, typename Compare = std::less<T>, std::size_t N = 8>
+class SmallSet {
+    static_assert(N > 0, "the inline buffer must hold at least one value");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_iterator = const T*;  // the values are contiguous and cannot be modified
+    using iterator = const_iterator;
+
+    static constexpr size_type inline_capacity = N;
+
+    /*
+     *  Default constructor: create an empty Set, without allocating memory
+     */
+    SmallSet() = default;
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    SmallSet(const T& val) {
+        small[0] = val;
+        count = 1;
+    }
+
+    /*
+     * Create a Set with all values in values, which must be sorted by Compare
+     * Repeated (equivalent) values are stored once
+     */
+    explicit SmallSet(const std::vector<T>& values) {
+        for (const T& val : values) {
+            append(val);
+        }
+    }
+
+    SmallSet(const SmallSet&) = default;
+    SmallSet& operator=(const SmallSet&) = default;
+
+    /*
+     * Move constructor: take the values of S, which becomes empty and inline
+     */
+    SmallSet(SmallSet&& S) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : small{std::move(S.small)}, large{std::move(S.large)}, count{S.count}, spilled{S.spilled}, comp{S.comp} {
+        S.make_empty();
+    }
+
+    /*
+     * Move assignment operator: take the values of S, which becomes empty and inline
+     */
+    SmallSet& operator=(SmallSet&& S) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        if (this != &S) {
+            small = std::move(S.small);
+            large = std::move(S.large);
+            count = S.count;
+            spilled = S.spilled;
+            comp = S.comp;
+            S.make_empty();
+        }
+        return *this;
+    }
+
+    /*
+     * Test whether the values are stored in the inline buffer, i.e. no memory is allocated
+     */
+    bool is_inline() const {
+        return !spilled;
+    }
+
+    bool is_empty() const {
+        return count == 0;
+    }
+
+    size_type cardinality() const {
+        return count;
+    }
+
+    const_iterator begin() const {
+        return data();
+    }
+
+    const_iterator end() const {
+        return data() + count;
+    }
+
+    /*
+     * Return an iterator to the first value not ordered before val, or end() if none: O(log n)
+     */
+    const_iterator lower_bound(const T& val) const {
+        return std::lower_bound(begin(), end(), val, comp);
+    }
+
+    /*
+     * Test whether val belongs to the Set: binary search, O(log n)
+     */
+    bool is_member(const T& val) const {
+        const_iterator it = lower_bound(val);
+        return it != end() && !comp(val, *it);
+    }
+
+    /*
+     * Insert val, return false if an equivalent value already belonged to the Set
+     * The values move to the heap when the inline buffer is full
+     */
+    bool insert(const T& val) {
+        const_iterator it = lower_bound(val);
+        if (it != end() && !comp(val, *it)) {
+            return false;
+        }
+
+        const auto i = static_cast<std::ptrdiff_t>(it - begin());
+        if (is_inline() && count == N) {
+            spill();
+        }
+
+        if (is_inline()) {
+            std::move_backward(small.begin() + i, small.begin() + static_cast<std::ptrdiff_t>(count),
+                               small.begin() + static_cast<std::ptrdiff_t>(count) + 1);
+            small[static_cast<size_type>(i)] = val;
+        } else {
+            large.insert(large.begin() + i, val);
+        }
+        ++count;
+        return true;
+    }
+
+    /*
+     * Remove the value equivalent to val, return false if there was none
+     * The values move back to the inline buffer when N / 2 values or less are left
+     */
+    bool erase(const T& val) {
+        const_iterator it = lower_bound(val);
+        if (it == end() || comp(val, *it)) {
+            return false;
+        }
+
+        const auto i = static_cast<std::ptrdiff_t>(it - begin());
+        if (is_inline()) {
+            std::move(small.begin() + i + 1, small.begin() + static_cast<std::ptrdiff_t>(count), small.begin() + i);
+        } else {
+            large.erase(large.begin() + i);
+        }
+        --count;
+        shrink();
+        return true;
+    }
+
+    /*
+     * Remove all values, and release the heap memory if any
+     */
+    void make_empty() {
+        count = 0;
+        spilled = false;
+        std::vector<T>{}.swap(large);
+    }
+
+    bool operator==(const SmallSet& S) const {
+        return count == S.count &&
+               std::equal(begin(), end(), S.begin(), [this](const T& x, const T& y) { return !comp(x, y) && !comp(y, x); });
+    }
+
+    /*
+     * Test whether every value of *this belongs to Set S
+     */
+    bool is_subset_of(const SmallSet& S) const {
+        return count <= S.count && std::includes(S.begin(), S.end(), begin(), end(), comp);
+    }
+
+    /*
+     * Three-way comparison operator: set inclusion, as for Set
+     */
+    std::partial_ordering operator<=>(const SmallSet& S) const {
+        if (count == S.count) {
+            return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+        }
+        if (count < S.count) {
+            return is_subset_of(S) ? std::partial_ordering::less : std::partial_ordering::unordered;
+        }
+        return S.is_subset_of(*this) ? std::partial_ordering::greater : std::partial_ordering::unordered;
+    }
+
+    /*
+     * Modify Set *this such that it becomes the union of *this with Set S
+     * The union is merged into a new SmallSet, which allocates only if it does not fit inline
+     */
+    SmallSet& operator+=(const SmallSet& S) {
+        SmallSet R{};
+        const_iterator a = begin();
+        const_iterator b = S.begin();
+
+        while (a != end() && b != S.end()) {
+            if (comp(*a, *b)) {
+                R.append(*a++);
+            } else if (comp(*b, *a)) {
+                R.append(*b++);
+            } else {
+                R.append(*a++);
+                ++b;
+            }
+        }
+        for (; a != end(); ++a) {
+            R.append(*a);
+        }
+        for (; b != S.end(); ++b) {
+            R.append(*b);
+        }
+
+        return *this = std::move(R);
+    }
+
+    /*
+     * Modify Set *this such that it becomes the intersection of *this with Set S
+     * The kept values are compacted in place
+     */
+    SmallSet& operator*=(const SmallSet& S) {
+        return keep(S, true);
+    }
+
+    /*
+     * Modify Set *this such that it becomes the Set difference *this - S
+     * The kept values are compacted in place
+     */
+    SmallSet& operator-=(const SmallSet& S) {
+        return keep(S, false);
+    }
+
+    friend SmallSet operator+(SmallSet S1, const SmallSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend SmallSet operator*(SmallSet S1, const SmallSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend SmallSet operator-(SmallSet S1, const SmallSet& S2) {
+        return (S1 -= S2);
+    }
+
+    /*
+     * Write the Set as Set does: "Set is empty!" or "{ v1 v2 ... }"
+     */
+    friend std::ostream& operator<<(std::ostream& os, const SmallSet& S) {
+        if (S.is_empty()) {
+            return os << "Set is empty!";
+        }
+        os << "{ ";
+        for (const T& val : S) {
+            os << val << " ";
+        }
+        return os << "}";
+    }
+
+private:
+    std::array<T, N> small{};  // the values, if count <= N
+    std::vector<T> large;      // the values, if spilled; empty otherwise
+    size_type count{0};        // number of values in the Set
+    bool spilled{false};       // whether the values are in large, always true if count > N
+    [[no_unique_address]] Compare comp{};
+
+    const T* data() const {
+        return is_inline() ? small.data() : large.data();
+    }
+
+    /*
+     * Append val, which must be ordered after all values of the Set
+     * Values equivalent to the last value are skipped
+     */
+    void append(const T& val) {
+        if (count > 0 && !comp(*(end() - 1), val)) {
+            return;
+        }
+        if (is_inline() && count == N) {
+            spill();
+        }
+
+        if (is_inline()) {
+            small[count] = val;
+        } else {
+            large.push_back(val);
+        }
+        ++count;
+    }
+
+    /*
+     * Keep the values that belong to S if common is true, the others if common is false
+     * Single merge with S, the kept values are moved towards the front in place
+     */
+    SmallSet& keep(const SmallSet& S, bool common) {
+        T* first = is_inline() ? small.data() : large.data();
+        T* out = first;
+        const_iterator b = S.begin();
+
+        for (T* a = first; a != first + count; ++a) {
+            while (b != S.end() && comp(*b, *a)) {
+                ++b;
+            }
+            if ((b != S.end() && !comp(*a, *b)) == common) {
+                if (out != a) {  // a self-move would leave e.g. a std::string empty
+                    *out = std::move(*a);
+                }
+                ++out;
+            }
+        }
+
+        count = static_cast<size_type>(out - first);
+        if (!is_inline()) {
+            large.resize(count);
+        }
+        shrink();
+        return *this;
+    }
+
+    /*
+     * Move the N values of the full inline buffer to the heap
+     */
+    void spill() {
+        large.reserve(2 * N);
+        large.assign(std::make_move_iterator(small.begin()), std::make_move_iterator(small.end()));
+        spilled = true;
+    }
+
+    /*
+     * Move the values back to the inline buffer if they fill at most half of it
+     */
+    void shrink() {
+        if (!is_inline() && count <= N / 2) {
+            std::move(large.begin(), large.end(), small.begin());
+            std::vector<T>{}.swap(large);
+            spilled = false;
+        }
+    }
+};
@@ -0,0 +1,305 @@
+#include "unrolled_set.h"
+#include "set_merge.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+/*****************************************************
+ * Construction                                       *
+ ******************************************************/
+
+/*
+ * Create an UnrolledSet storing the values of Set S
+ */
+UnrolledSet::UnrolledSet(const Set& S) {
+    for (int val : S) {
+        append(val);
+    }
+}
+
+/*
+ * Create an UnrolledSet storing the sorted unique ints in values
+ */
+UnrolledSet::UnrolledSet(std::span<const int> values) {
+    for (int val : values) {
+        append(val);
+    }
+}
+
+/*
+ * Copy constructor: copy the Blocks of U, one array at a time
+ */
+UnrolledSet::UnrolledSet(const UnrolledSet& U) : counter{U.counter} {
+    for (const Block* b = U.first; b != nullptr; b = b->next) {
+        Block* copy = new Block{b->values, b->size, nullptr, last};
+        (last != nullptr ? last->next : first) = copy;
+        last = copy;
+    }
+}
+
+/*
+ * Move constructor: take the Blocks of U, which becomes empty
+ */
+UnrolledSet::UnrolledSet(UnrolledSet&& U) noexcept
+    : first{std::exchange(U.first, nullptr)}, last{std::exchange(U.last, nullptr)},
+      counter{std::exchange(U.counter, 0)} {
+}
+
+/*
+ * Destructor: deallocate all Blocks
+ */
+UnrolledSet::~UnrolledSet() {
+    while (first != nullptr) {
+        delete std::exchange(first, first->next);
+    }
+}
+
+/*
+ * Assignment operator: call by value, then swap
+ */
+UnrolledSet& UnrolledSet::operator=(UnrolledSet U) {
+    std::swap(first, U.first);
+    std::swap(last, U.last);
+    std::swap(counter, U.counter);
+    return *this;
+}
+
+/*****************************************************
+ * Queries                                            *
+ ******************************************************/
+
+/*
+ * Return the number of Blocks of the list
+ */
+size_t UnrolledSet::block_count() const {
+    size_t n = 0;
+    for (const Block* b = first; b != nullptr; b = b->next) {
+        ++n;
+    }
+    return n;
+}
+
+/*
+ * Test whether val belongs to the Set
+ */
+bool UnrolledSet::is_member(int val) const {
+    const Block* b = find_block(val);
+    return b != nullptr && std::binary_search(b->values.begin(), b->values.begin() + b->size, val);
+}
+
+UnrolledSet::const_iterator UnrolledSet::begin() const {
+    const_iterator it{};
+    it.block = first;
+    return it;
+}
+
+UnrolledSet::const_iterator UnrolledSet::end() const {
+    return const_iterator{};
+}
+
+UnrolledSet::const_iterator::reference UnrolledSet::const_iterator::operator*() const {
+    return block->values[static_cast<size_t>(pos)];
+}
+
+UnrolledSet::const_iterator& UnrolledSet::const_iterator::operator++() {
+    if (++pos == block->size) {
+        block = block->next;
+        pos = 0;
+    }
+    return *this;
+}
+
+/*
+ * Create a Set with the values of the UnrolledSet
+ */
+Set UnrolledSet::to_set() const {
+    return Set{std::vector<int>(begin(), end())};
+}
+
+bool UnrolledSet::operator==(const UnrolledSet& U) const {
+    return counter == U.counter && std::equal(begin(), end(), U.begin());
+}
+
+/*****************************************************
+ * Modifications                                      *
+ ******************************************************/
+
+/*
+ * Insert val, return false if it already belonged to the Set
+ */
+bool UnrolledSet::insert(int val) {
+    Block* b = find_block(val);
+    if (b == nullptr) {  // val is larger than all values
+        append(val);
+        return true;
+    }
+
+    int* pos = std::lower_bound(b->values.data(), b->values.data() + b->size, val);
+    if (*pos == val) {  // pos is valid: the largest value of b is >= val
+        return false;
+    }
+
+    if (b->size == block_capacity) {  // split the Block in two halves
+        Block* upper = new Block;
+        upper->size = block_capacity / 2;
+        std::copy(b->values.begin() + block_capacity / 2, b->values.end(), upper->values.begin());
+        b->size = block_capacity / 2;
+
+        upper->prev = b;
+        upper->next = b->next;
+        (b->next != nullptr ? b->next->prev : last) = upper;
+        b->next = upper;
+
+        if (val > b->last()) {
+            b = upper;
+        }
+        pos = std::lower_bound(b->values.data(), b->values.data() + b->size, val);
+    }
+
+    std::move_backward(pos, b->values.data() + b->size, b->values.data() + b->size + 1);
+    *pos = val;
+    ++b->size;
+    ++counter;
+    return true;
+}
+
+/*
+ * Remove val, return false if it did not belong to the Set
+ */
+bool UnrolledSet::erase(int val) {
+    Block* b = find_block(val);
+    if (b == nullptr) {
+        return false;
+    }
+
+    int* pos = std::lower_bound(b->values.data(), b->values.data() + b->size, val);
+    if (*pos != val) {
+        return false;
+    }
+
+    std::move(pos + 1, b->values.data() + b->size, pos);
+    --b->size;
+    --counter;
+
+    if (b->size == 0) {
+        remove_block(b);
+    } else if (b->size < block_capacity / 4) {  // merge b with a neighbour, if they fit in one Block
+        if (b->next != nullptr && b->size + b->next->size <= block_capacity) {
+            std::copy_n(b->next->values.begin(), b->next->size, b->values.begin() + b->size);
+            b->size += b->next->size;
+            remove_block(b->next);
+        } else if (b->prev != nullptr && b->prev->size + b->size <= block_capacity) {
+            std::copy_n(b->values.begin(), b->size, b->prev->values.begin() + b->prev->size);
+            b->prev->size += b->size;
+            remove_block(b);
+        }
+    }
+    return true;
+}
+
+UnrolledSet& UnrolledSet::operator+=(const UnrolledSet& U) {
+    return merge(U, keep_union);
+}
+
+UnrolledSet& UnrolledSet::operator*=(const UnrolledSet& U) {
+    return merge(U, keep_intersection);
+}
+
+UnrolledSet& UnrolledSet::operator-=(const UnrolledSet& U) {
+    return merge(U, keep_difference);
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Return the first Block whose largest value is >= val, or nullptr if none
+ */
+UnrolledSet::Block* UnrolledSet::find_block(int val) const {
+    Block* b = first;
+    while (b != nullptr && b->last() < val) {
+        b = b->next;
+    }
+    return b;
+}
+
+/*
+ * Append val after the last value, allocating a new Block if the last Block is full
+ */
+void UnrolledSet::append(int val) {
+    if (last == nullptr || last->size == block_capacity) {
+        Block* b = new Block;
+        b->prev = last;
+        (last != nullptr ? last->next : first) = b;
+        last = b;
+    }
+    last->values[static_cast<size_t>(last->size++)] = val;
+    ++counter;
+}
+
+/*
+ * Unlink Block b from the list and deallocate it
+ */
+void UnrolledSet::remove_block(Block* b) {
+    (b->prev != nullptr ? b->prev->next : first) = b->next;
+    (b->next != nullptr ? b->next->prev : last) = b->prev;
+    delete b;
+}
+
+/*
+ * Merge U into *this, one pair of Blocks at a time
+ */
+template <typename Keep>
+UnrolledSet& UnrolledSet::merge(const UnrolledSet& U, Keep keep) {
+    UnrolledSet R{};
+    const Block* a = first;
+    const Block* b = U.first;
+    int i = 0;
+    int j = 0;
+
+    while (a != nullptr && b != nullptr) {
+        const int* va = a->values.data();
+        const int* vb = b->values.data();
+
+        // Merge until one of the two arrays is exhausted
+        while (i < a->size && j < b->size) {
+            const int x = va[i];
+            const int y = vb[j];
+            if (x < y) {
+                if (keep(true, false)) R.append(x);
+                ++i;
+            } else if (y < x) {
+                if (keep(false, true)) R.append(y);
+                ++j;
+            } else {
+                if (keep(true, true)) R.append(x);
+                ++i;
+                ++j;
+            }
+        }
+
+        if (i == a->size) {
+            a = a->next;
+            i = 0;
+        }
+        if (j == b->size) {
+            b = b->next;
+            j = 0;
+        }
+    }
+
+    for (; a != nullptr && keep(true, false); a = a->next, i = 0) {
+        for (; i < a->size; ++i) {
+            R.append(a->values[static_cast<size_t>(i)]);
+        }
+    }
+    for (; b != nullptr && keep(false, true); b = b->next, j = 0) {
+        for (; j < b->size; ++j) {
+            R.append(b->values[static_cast<size_t>(j)]);
+        }
+    }
+
+    return *this = std::move(R);
+}
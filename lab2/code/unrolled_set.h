@@ -0,0 +1,190 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <span>
+
+#include "set.h"
+
+/** Class to represent a Set of ints as an unrolled linked list
+ *
+ * UnrolledSet is a sorted doubly linked list of Blocks, each storing a sorted array of
+ * at most block_capacity ints, so traversals follow one pointer per Block instead of one per value
+ * A full Block is split in two halves when a value is inserted into it, and a Block
+ * that falls below a quarter of its capacity is merged with a neighbour when they fit in one Block
+ *
+ * Union, intersection and difference merge the arrays of the Blocks with tight inner loops,
+ * and fill the Blocks of the result completely
+ */
+class UnrolledSet {
+    struct Block;
+
+public:
+    static constexpr int block_capacity = 32;  // maximum number of values in a Block
+
+    /*
+     * Forward iterator over the values of an UnrolledSet, in increasing order
+     * Invalidated by any modification of the UnrolledSet
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        const_iterator() = default;
+
+        reference operator*() const;
+        const_iterator& operator++();
+
+        const_iterator operator++(int) {
+            const_iterator it{*this};
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const const_iterator& it) const = default;
+
+    private:
+        friend class UnrolledSet;
+
+        const Block* block{nullptr};  // nullptr for end()
+        int pos{0};                   // index of the value in the Block
+    };
+
+    /*
+     * Default constructor: create an empty UnrolledSet
+     */
+    UnrolledSet() = default;
+
+    /*
+     * Create an UnrolledSet storing the values of Set S
+     */
+    explicit UnrolledSet(const Set& S);
+
+    /*
+     * Create an UnrolledSet storing the sorted unique ints in values
+     */
+    explicit UnrolledSet(std::span<const int> values);
+
+    /*
+     * Copy constructor: create a new UnrolledSet as a copy of U
+     */
+    UnrolledSet(const UnrolledSet& U);
+
+    /*
+     * Move constructor: take the Blocks of U, which becomes empty
+     */
+    UnrolledSet(UnrolledSet&& U) noexcept;
+
+    /*
+     * Destructor: deallocate all Blocks
+     */
+    ~UnrolledSet();
+
+    /*
+     * Assignment operator: call by value, then swap
+     */
+    UnrolledSet& operator=(UnrolledSet U);
+
+    size_t cardinality() const {
+        return counter;
+    }
+
+    bool is_empty() const {
+        return counter == 0;
+    }
+
+    /*
+     * Return the number of Blocks of the list
+     */
+    size_t block_count() const;
+
+    /*
+     * Test whether val belongs to the Set
+     * Blocks are skipped by their largest value, then val is searched in one array
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Insert val, return false if it already belonged to the Set
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val, return false if it did not belong to the Set
+     */
+    bool erase(int val);
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Create a Set with the values of the UnrolledSet
+     */
+    Set to_set() const;
+
+    bool operator==(const UnrolledSet& U) const;
+
+    /*
+     * Union, intersection and difference: a single merge of the Blocks into new Blocks
+     */
+    UnrolledSet& operator+=(const UnrolledSet& U);
+    UnrolledSet& operator*=(const UnrolledSet& U);
+    UnrolledSet& operator-=(const UnrolledSet& U);
+
+    friend UnrolledSet operator+(UnrolledSet U1, const UnrolledSet& U2) {
+        return (U1 += U2);
+    }
+
+    friend UnrolledSet operator*(UnrolledSet U1, const UnrolledSet& U2) {
+        return (U1 *= U2);
+    }
+
+    friend UnrolledSet operator-(UnrolledSet U1, const UnrolledSet& U2) {
+        return (U1 -= U2);
+    }
+
+private:
+    struct Block {
+        std::array<int, block_capacity> values;  // sorted, the first size entries are used
+        int size{0};
+        Block* next{nullptr};
+        Block* prev{nullptr};
+
+        int last() const {
+            return values[static_cast<size_t>(size - 1)];
+        }
+    };
+
+    Block* first{nullptr};  // nullptr if the Set is empty, Blocks are never empty
+    Block* last{nullptr};
+    size_t counter{0};      // number of values in the Set
+
+    /*
+     * Return the first Block whose largest value is >= val, or nullptr if none
+     */
+    Block* find_block(int val) const;
+
+    /*
+     * Append val after the last value, allocating a new Block if the last Block is full
+     */
+    void append(int val);
+
+    /*
+     * Unlink Block b from the list and deallocate it
+     */
+    void remove_block(Block* b);
+
+    /*
+     * Merge U into *this: keep the values of *this only, of U only and of both
+     * according to keep (see set_merge.h)
+     */
+    template <typename Keep>
+    UnrolledSet& merge(const UnrolledSet& U, Keep keep);
+};
+
+static_assert(std::forward_iterator<UnrolledSet::const_iterator>);
@@ -7,12 +7,200 @@
 #include <rendering/window.h>
 #include <fmt/format.h>
 
-#include <unordered_map>
 #include <set>
 #include <fstream>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <algorithm>
 
 void plotData(const std::string& name);
 
+/* ****************** SLOPES ****************** */
+
+/*
+ * Exact slope of the line through the points a and b, with integer coordinates
+ * (dx, dy) is divided by gcd(dx, dy) and its sign normalized (dx > 0, or dx == 0 and dy > 0),
+ * so that all points on a line through a get the same key: no rounding, no -0
+ * dx and dy are packed in one 64-bit key
+ */
+std::uint64_t slopeKey(std::pair<int, int> a, std::pair<int, int> b) {
+    int dx = b.first - a.first;
+    int dy = b.second - a.second;
+
+    const int g = std::gcd(dx, dy);  // > 0, since a != b
+    dx /= g;
+    dy /= g;
+
+    if (dx < 0 || (dx == 0 && dy < 0)) {
+        dx = -dx;
+        dy = -dy;
+    }
+    return (std::uint64_t{static_cast<std::uint32_t>(dx)} << 32) | static_cast<std::uint32_t>(dy);
+}
+
+/*
+ * Hash table from slope keys to the indices of the points with that slope from an anchor
+ * Open addressing with linear probing in one flat vector: inserting a point costs one probe
+ * in most cases, and clear() keeps the capacity of the table and of the index lists
+ */
+class SlopeTable {
+public:
+    struct Entry {
+        std::uint64_t key = 0;
+        bool used = false;
+        std::vector<int> points;  // indices of the points
+    };
+
+    explicit SlopeTable(std::size_t expected) {
+        std::size_t n = 16;
+        while (n < 2 * expected) {  // load factor at most 1/2
+            n *= 2;
+        }
+        table.resize(n);
+    }
+
+    void add(std::uint64_t key, int point) {
+        std::size_t i = hash(key);
+        while (table[i].used && table[i].key != key) {
+            i = (i + 1) & (table.size() - 1);
+        }
+
+        if (!table[i].used) {
+            table[i].used = true;
+            table[i].key = key;
+            used.push_back(i);
+        }
+        table[i].points.push_back(point);
+    }
+
+    // Visit the entries in use
+    template <typename F>
+    void forEach(F f) const {
+        for (std::size_t i : used) {
+            f(table[i]);
+        }
+    }
+
+    void clear() {
+        for (std::size_t i : used) {
+            table[i].used = false;
+            table[i].points.clear();
+        }
+        used.clear();
+    }
+
+private:
+    std::vector<Entry> table;      // size is a power of 2
+    std::vector<std::size_t> used;  // indices of the entries in use
+
+    std::size_t hash(std::uint64_t key) const {
+        key ^= key >> 29;
+        key *= 0xBF58476D1CE4E5B9ull;
+        key ^= key >> 32;
+        return static_cast<std::size_t>(key) & (table.size() - 1);
+    }
+};
+
+using LineSet = std::set<std::pair<int, std::set<std::pair<int, int>>>>;  // (y of first point, points of the line)
+
+/*
+ * Find the lines through at least 4 points with a SlopeTable
+ * For each anchor point, the following points are grouped by slope key in the hash table,
+ * and every group of at least 3 points is a line
+ * O(n^2) expected time; the table is reused for every anchor
+ */
+LineSet findLinesHashed(const std::vector<std::pair<int, int>>& coords) {
+    LineSet lines;
+    SlopeTable slopes{coords.size()};
+
+    for (int p1 = 0; p1 < std::ssize(coords) - 1; p1++)                     // Anchor point
+    {
+        slopes.clear();
+        for (int p2 = p1 + 1; p2 < std::ssize(coords); p2++)
+        {
+            if (coords[p1] != coords[p2])                                   // Same position: no slope
+            {
+                slopes.add(slopeKey(coords[p1], coords[p2]), p2);           // Exact slope, one probe
+            }
+        }
+
+        slopes.forEach([&](const SlopeTable::Entry& e) {
+            if (e.points.size() >= 3)                                       // Anchor and at least 3 other points
+            {
+                std::set<std::pair<int, int>> line{coords[p1]};
+                for (int p : e.points)
+                {
+                    line.insert(coords[p]);
+                }
+                lines.insert({line.begin()->second, std::move(line)});     // Sorted on the first point's y value
+            }
+        });
+    }
+
+    return lines;
+}
+
+/*
+ * Find the lines through at least 4 points by sorting
+ * For each anchor point, the (slope key, point index) entries of the following points are
+ * stored in one buffer, sorted by slope, and scanned for runs of at least 3 equal slopes
+ * O(n^2 log n) time; the buffer is reused for every anchor, so the inner loops allocate nothing
+ */
+LineSet findLinesSorted(const std::vector<std::pair<int, int>>& coords) {
+    LineSet lines;
+
+    std::vector<std::pair<std::uint64_t, int>> entries;                    // (slope key, point index)
+    entries.reserve(coords.size());
+
+    for (int p1 = 0; p1 < std::ssize(coords) - 1; p1++)                     // Anchor point
+    {
+        entries.clear();
+        for (int p2 = p1 + 1; p2 < std::ssize(coords); p2++)
+        {
+            if (coords[p1] != coords[p2])                                   // Same position: no slope
+            {
+                entries.push_back({slopeKey(coords[p1], coords[p2]), p2});
+            }
+        }
+        std::sort(entries.begin(), entries.end());                         // Equal slopes are now adjacent
+
+        for (std::size_t first = 0; first < entries.size();)              // Scan the runs of equal slopes
+        {
+            std::size_t last = first + 1;
+            while (last < entries.size() && entries[last].first == entries[first].first)
+            {
+                ++last;
+            }
+
+            if (last - first >= 3)                                          // Anchor and at least 3 other points
+            {
+                std::set<std::pair<int, int>> line{coords[p1]};
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    line.insert(coords[entries[i].second]);
+                }
+                lines.insert({line.begin()->second, std::move(line)});     // Sorted on the first point's y value
+            }
+            first = last;
+        }
+    }
+
+    return lines;
+}
+
+/*
+ * The two ways of grouping the points by slope: both find the same lines
+ * sorted is the default: its one flat buffer is scanned sequentially, while hashed
+ * has a better complexity but keeps one vector of point indices per slope
+ */
+enum class SlopeGrouping { sorted, hashed };
+
+LineSet findLines(const std::vector<std::pair<int, int>>& coords, SlopeGrouping grouping = SlopeGrouping::sorted) {
+    return (grouping == SlopeGrouping::hashed) ? findLinesHashed(coords) : findLinesSorted(coords);
+}
+
 /* ************************************* */
 
 /* ****************** MAIN ****************** */
@@ -37,8 +225,9 @@ void plotData(const std::string& name) {
     const auto points = readPoints(data_dir / points_name);
 
     /********************************************************************************
-     *   unordered_map:  Container that contains key - value pairs with unique keys  *
-     *                   Search, Insertion and Removal = O(1)                        *
+     *   findLines:      Groups the points by exact slope from each anchor point,    *
+     *                   by sorting (O(n^2 log n), one reused buffer) or with a      *
+     *                   SlopeTable (flat hash table, O(n^2) expected)               *
      *                                                                               *
      *   set:            Stores unique elements, automatically sorted (ascending)    *
      *                   Search, Insertion and Removal = O(log n)                    *
@@ -46,56 +235,16 @@ void plotData(const std::string& name) {
      *   pair:           class for points, holds (x,y)                               *
      *********************************************************************************/
 
-    std::set<std::pair<int, std::set<std::pair<int, int>>>> linesToDraw;  // No need for map since we just need a simple vector holding sets of pairs.
+    // Integer coordinates of the points (non-normalized)
+    std::vector<std::pair<int, int>> coords;
+    coords.reserve(points.size());
+    for (const auto& p : points) {
+        coords.push_back({static_cast<int>(std::lround(p.position.x * 32767)),
+                          static_cast<int>(std::lround(p.position.y * 32767))});
+    }
 
     // ************ CALCULATE SLOPE & INSERT INTO VECTOR ************
-    for (int p1 = 0; p1 < std::ssize(points) - 1; p1++)                     // Point1 chosen to compare other points with
-    {
-        std::unordered_map<float, std::set<std::pair<int, int>>> slopes;    // Calculate slopes independently for every iteration
-
-        for (int p2 = p1 + 1; p2 < std::ssize(points); p2++)                // Loop through rest of points to compare to Point1
-        {
-                                                                            // Point 1 Coordinates (non-normalized)
-            float X1 = points[p1].position.x * 32767;
-            float Y1 = points[p1].position.y * 32767;
-
-                                                                            // Point 2 Coordinates (non-normalized)
-            float X2 = points[p2].position.x * 32767;
-            float Y2 = points[p2].position.y * 32767;
-
-            float k;                                                        // Slope value
-            if (X1 != X2)                                                   // If the denominator is not = 0
-            {
-                k = (Y2 - Y1) / (X2 - X1);                                  // Slope calculations
-            } 
-            else 
-            {
-                k = std::numeric_limits<float>::infinity();                 // Divided by 0 --> infinity
-            }
-
-            // If we are not comparing the same points with each other.
-            if (p1 != p2) 
-            {                                                 
-                if (k == -0) 
-                {                                              // Keep zeros positive.
-                    k = 0;
-                }
-
-                // insert points in the index with same k value
-                slopes[k].insert({X1, Y1});                                 // Insert first point
-                slopes[k].insert({X2, Y2});                                 // Insert second point
-            }
-        }
-
-        // Sort line segments depending on first point's y value
-        for (auto& e : slopes) 
-        {
-            if (e.second.size() > 3) 
-            {
-                linesToDraw.insert({(*(e.second.begin())).second, std::move(e.second)});    // Inserting the y values into lineToDraw
-            }
-        }
-    }
+    LineSet linesToDraw = findLines(coords);
 
     // ************ CREATION OF LINES ************
 